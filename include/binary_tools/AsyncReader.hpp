@@ -0,0 +1,772 @@
+#pragma once
+
+// Coroutine based async file reads. Opt-in since it needs C++20. The rest of the library is C++17, so only projects
+// that include this header have to build with C++20 (e.g. set_languages("c++20") in their own xmake target).
+#if !defined(__cpp_impl_coroutine)
+#error "AsyncReader.hpp requires C++20 coroutines. Build the project that includes it with -std=c++20 or /std:c++20"
+#else
+
+#include <algorithm>
+#include <atomic>
+#include <coroutine>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <exception>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#undef min
+#undef max
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+#endif
+
+#if defined(__linux__)
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#define BINARY_TOOLS_IO_URING
+#endif
+
+namespace binary_tools
+{
+#if defined(_WIN32)
+    using NativeFileHandle = HANDLE;
+#else
+    using NativeFileHandle = int;
+#endif
+
+    template <typename T = void>
+    class Task;
+
+#pragma region Task
+    class TaskPromiseBase
+    {
+    public:
+        std::suspend_always initial_suspend() noexcept
+        {
+            return {};
+        }
+
+        // Resume whoever is awaiting the task, if anyone
+        auto final_suspend() noexcept
+        {
+            struct FinalAwaiter
+            {
+                bool await_ready() noexcept
+                {
+                    return false;
+                }
+
+                std::coroutine_handle<> await_suspend(std::coroutine_handle<>) noexcept
+                {
+                    return continuation_ ? continuation_ : std::noop_coroutine();
+                }
+
+                void await_resume() noexcept
+                {
+                }
+
+                std::coroutine_handle<> continuation_;
+            };
+            return FinalAwaiter{continuation_};
+        }
+
+        void unhandled_exception()
+        {
+            exception_ = std::current_exception();
+        }
+
+        void SetContinuation(std::coroutine_handle<> continuation)
+        {
+            continuation_ = continuation;
+        }
+
+    protected:
+        void RethrowIfFailed()
+        {
+            if (exception_)
+                std::rethrow_exception(exception_);
+        }
+
+        std::coroutine_handle<> continuation_;
+        std::exception_ptr exception_;
+    };
+
+    template <typename T>
+    class TaskPromise : public TaskPromiseBase
+    {
+    public:
+        Task<T> get_return_object();
+
+        void return_value(T value)
+        {
+            value_ = std::move(value);
+        }
+
+        T Result()
+        {
+            RethrowIfFailed();
+            return std::move(*value_);
+        }
+
+    private:
+        std::optional<T> value_;
+    };
+
+    template <>
+    class TaskPromise<void> : public TaskPromiseBase
+    {
+    public:
+        Task<void> get_return_object();
+
+        void return_void()
+        {
+        }
+
+        void Result()
+        {
+            RethrowIfFailed();
+        }
+    };
+
+    // Lazily started coroutine. Runs when it's co_awaited or passed to IoContext::Spawn()/Run()
+    template <typename T>
+    class Task
+    {
+    public:
+        using promise_type = TaskPromise<T>;
+
+        Task() = default;
+
+        explicit Task(std::coroutine_handle<promise_type> handle)
+            : handle_(handle)
+        {
+        }
+
+        Task(Task &&other) noexcept
+            : handle_(std::exchange(other.handle_, nullptr))
+        {
+        }
+
+        Task &operator=(Task &&other) noexcept
+        {
+            if (this != &other)
+            {
+                if (handle_)
+                    handle_.destroy();
+
+                handle_ = std::exchange(other.handle_, nullptr);
+            }
+            return *this;
+        }
+
+        Task(const Task &) = delete;
+        Task &operator=(const Task &) = delete;
+
+        ~Task()
+        {
+            if (handle_)
+                handle_.destroy();
+        }
+
+        bool await_ready() const noexcept
+        {
+            return !handle_ || handle_.done();
+        }
+
+        // Start the task and resume the awaiting coroutine once it finishes
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept
+        {
+            handle_.promise().SetContinuation(awaiting);
+            return handle_;
+        }
+
+        T await_resume()
+        {
+            return handle_.promise().Result();
+        }
+
+    private:
+        std::coroutine_handle<promise_type> handle_;
+    };
+
+    template <typename T>
+    Task<T> TaskPromise<T>::get_return_object()
+    {
+        return Task<T>(std::coroutine_handle<TaskPromise<T>>::from_promise(*this));
+    }
+
+    inline Task<void> TaskPromise<void>::get_return_object()
+    {
+        return Task<void>(std::coroutine_handle<TaskPromise<void>>::from_promise(*this));
+    }
+#pragma endregion
+
+    // A positional read that's been handed to an IoContext. Short reads are resubmitted until size bytes arrive or the file ends
+    struct IoOperation
+    {
+        NativeFileHandle File{};
+        uint8_t *Destination = nullptr;
+        size_t Size = 0;
+        size_t Offset = 0;
+        size_t Done = 0; // Bytes read so far
+        int Error = 0;   // errno (GetLastError() on Windows) of a failed read
+        std::coroutine_handle<> Handle;
+#if defined(BINARY_TOOLS_IO_URING)
+        iovec Vector{};
+#endif
+    };
+
+    enum class IoBackend
+    {
+        Auto,       // io_uring when the kernel allows it, otherwise Synchronous
+        IoUring,    // Throws if io_uring isn't available
+        Synchronous // Reads are done one at a time with pread inside Run(). For platforms and sandboxes without io_uring
+    };
+
+    // Single threaded event loop for async reads. Coroutines are started with Spawn() and driven by Run().
+    // Reads issued by any coroutine are batched into one io_uring submission per loop iteration, so one thread can keep
+    // hundreds of reads in flight while other coroutines parse data that's already arrived.
+    // epoll isn't used since it can't wait on regular files. Without io_uring reads complete synchronously inside Run().
+    class IoContext
+    {
+    public:
+        static constexpr unsigned DefaultQueueDepth = 256;
+        static constexpr size_t MaxReadSize = 1u << 30; // Larger reads are split
+
+        explicit IoContext(unsigned queueDepth = DefaultQueueDepth, IoBackend backend = IoBackend::Auto)
+        {
+#if defined(BINARY_TOOLS_IO_URING)
+            if (backend != IoBackend::Synchronous)
+            {
+                const int error = SetupRing(queueDepth);
+                if (error != 0 && backend == IoBackend::IoUring)
+                    throw std::system_error(error, std::generic_category(), "IoContext: Failed to create io_uring");
+            }
+#else
+            (void)queueDepth;
+            if (backend == IoBackend::IoUring)
+                throw std::runtime_error("IoContext: io_uring isn't available on this platform");
+#endif
+        }
+
+        IoContext(const IoContext &) = delete;
+        IoContext &operator=(const IoContext &) = delete;
+
+        // Run() must have finished every spawned task before the context is destroyed
+        ~IoContext()
+        {
+#if defined(BINARY_TOOLS_IO_URING)
+            if (ringFd_ >= 0)
+            {
+                if (sqes_)
+                    munmap(sqes_, sqesSize_);
+                if (cqRing_ && cqRing_ != sqRing_)
+                    munmap(cqRing_, cqRingSize_);
+                if (sqRing_)
+                    munmap(sqRing_, sqRingSize_);
+
+                ::close(ringFd_);
+            }
+#endif
+        }
+
+        IoBackend Backend() const
+        {
+#if defined(BINARY_TOOLS_IO_URING)
+            if (ringFd_ >= 0)
+                return IoBackend::IoUring;
+#endif
+            return IoBackend::Synchronous;
+        }
+
+        // Schedule a task. It starts on the next call to Run()
+        void Spawn(Task<void> task)
+        {
+            ready_.push_back(RunDetached(*this, std::move(task)).Handle);
+        }
+
+        // Run coroutines and complete reads until every spawned task has finished.
+        // Rethrows the first exception that escaped a spawned task once the rest are done.
+        void Run()
+        {
+            while (true)
+            {
+                while (!ready_.empty())
+                {
+                    const std::coroutine_handle<> handle = ready_.front();
+                    ready_.pop_front();
+                    handle.resume();
+                }
+
+                if (pending_.empty() && inKernel_ == 0)
+                    break;
+
+#if defined(BINARY_TOOLS_IO_URING)
+                if (ringFd_ >= 0)
+                {
+                    SubmitAndWait();
+                    continue;
+                }
+#endif
+                IoOperation *operation = pending_.front();
+                pending_.pop_front();
+                ReadSynchronous(*operation);
+                ready_.push_back(operation->Handle);
+            }
+
+            if (exception_)
+                std::rethrow_exception(std::exchange(exception_, nullptr));
+        }
+
+        // Run a task to completion along with anything else that's been spawned and return its result
+        template <typename T>
+        T Run(Task<T> task)
+        {
+            if constexpr (std::is_void_v<T>)
+            {
+                Spawn(std::move(task));
+                Run();
+            }
+            else
+            {
+                std::optional<T> result;
+                Spawn(Capture(std::move(task), result));
+                Run();
+                return std::move(*result);
+            }
+        }
+
+        // Queue a read. Called by the read awaitables once their coroutine is suspended
+        void Submit(IoOperation &operation)
+        {
+            pending_.push_back(&operation);
+        }
+
+    private:
+        struct DetachedTask
+        {
+            struct promise_type
+            {
+                DetachedTask get_return_object()
+                {
+                    return {std::coroutine_handle<promise_type>::from_promise(*this)};
+                }
+
+                std::suspend_always initial_suspend() noexcept
+                {
+                    return {};
+                }
+
+                std::suspend_never final_suspend() noexcept
+                {
+                    return {};
+                }
+
+                void return_void()
+                {
+                }
+
+                void unhandled_exception()
+                {
+                    std::terminate(); // RunDetached() catches everything
+                }
+            };
+
+            std::coroutine_handle<promise_type> Handle;
+        };
+
+        static DetachedTask RunDetached(IoContext &context, Task<void> task)
+        {
+            try
+            {
+                co_await task;
+            }
+            catch (...)
+            {
+                if (!context.exception_)
+                    context.exception_ = std::current_exception();
+            }
+        }
+
+        template <typename T>
+        static Task<void> Capture(Task<T> task, std::optional<T> &result)
+        {
+            result = co_await task;
+        }
+
+        static void ReadSynchronous(IoOperation &operation)
+        {
+            while (operation.Done < operation.Size)
+            {
+                const size_t size = std::min(operation.Size - operation.Done, MaxReadSize);
+                const size_t offset = operation.Offset + operation.Done;
+#if defined(_WIN32)
+                OVERLAPPED overlapped = {};
+                overlapped.Offset = static_cast<DWORD>(offset);
+                overlapped.OffsetHigh = static_cast<DWORD>(static_cast<uint64_t>(offset) >> 32);
+                DWORD count = 0;
+                if (!ReadFile(operation.File, operation.Destination + operation.Done, static_cast<DWORD>(size), &count, &overlapped))
+                {
+                    const DWORD error = GetLastError();
+                    if (error != ERROR_HANDLE_EOF)
+                        operation.Error = static_cast<int>(error);
+                    return;
+                }
+#else
+                const ssize_t count = ::pread(operation.File, operation.Destination + operation.Done, size, static_cast<off_t>(offset));
+                if (count < 0)
+                {
+                    if (errno == EINTR)
+                        continue;
+
+                    operation.Error = errno;
+                    return;
+                }
+#endif
+                if (count == 0)
+                    return; // End of file
+
+                operation.Done += static_cast<size_t>(count);
+            }
+        }
+
+#if defined(BINARY_TOOLS_IO_URING)
+        // Returns 0 or an errno value
+        int SetupRing(unsigned queueDepth)
+        {
+            io_uring_params params;
+            std::memset(&params, 0, sizeof(params));
+            const long fd = syscall(__NR_io_uring_setup, std::max(queueDepth, 1u), &params);
+            if (fd < 0)
+                return errno; // ENOSYS on old kernels, EPERM when blocked by seccomp
+
+            ringFd_ = static_cast<int>(fd);
+            sqRingSize_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+            cqRingSize_ = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+            if (params.features & IORING_FEAT_SINGLE_MMAP)
+                sqRingSize_ = cqRingSize_ = std::max(sqRingSize_, cqRingSize_);
+
+            void *sqRing = mmap(nullptr, sqRingSize_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd_, IORING_OFF_SQ_RING);
+            if (sqRing == MAP_FAILED)
+                return CloseRing();
+            sqRing_ = sqRing;
+
+            if (params.features & IORING_FEAT_SINGLE_MMAP)
+            {
+                cqRing_ = sqRing_;
+            }
+            else
+            {
+                void *cqRing = mmap(nullptr, cqRingSize_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd_, IORING_OFF_CQ_RING);
+                if (cqRing == MAP_FAILED)
+                    return CloseRing();
+                cqRing_ = cqRing;
+            }
+
+            sqesSize_ = params.sq_entries * sizeof(io_uring_sqe);
+            void *sqes = mmap(nullptr, sqesSize_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd_, IORING_OFF_SQES);
+            if (sqes == MAP_FAILED)
+                return CloseRing();
+            sqes_ = static_cast<io_uring_sqe *>(sqes);
+
+            uint8_t *sq = static_cast<uint8_t *>(sqRing_);
+            sqHead_ = reinterpret_cast<unsigned *>(sq + params.sq_off.head);
+            sqTail_ = reinterpret_cast<unsigned *>(sq + params.sq_off.tail);
+            sqMask_ = *reinterpret_cast<unsigned *>(sq + params.sq_off.ring_mask);
+            sqEntries_ = params.sq_entries;
+            sqArray_ = reinterpret_cast<unsigned *>(sq + params.sq_off.array);
+
+            uint8_t *cq = static_cast<uint8_t *>(cqRing_);
+            cqHead_ = reinterpret_cast<unsigned *>(cq + params.cq_off.head);
+            cqTail_ = reinterpret_cast<unsigned *>(cq + params.cq_off.tail);
+            cqMask_ = *reinterpret_cast<unsigned *>(cq + params.cq_off.ring_mask);
+            cqes_ = reinterpret_cast<io_uring_cqe *>(cq + params.cq_off.cqes);
+            cqEntries_ = params.cq_entries;
+            return 0;
+        }
+
+        // Undo a partial SetupRing() so the synchronous backend is used. Returns errno
+        int CloseRing()
+        {
+            const int error = errno;
+            if (sqRing_)
+                munmap(sqRing_, sqRingSize_);
+            if (cqRing_ && cqRing_ != sqRing_)
+                munmap(cqRing_, cqRingSize_);
+
+            ::close(ringFd_);
+            ringFd_ = -1;
+            sqRing_ = cqRing_ = nullptr;
+            return error;
+        }
+
+        // Move pending reads into the submission queue, submit them and wait for at least one completion
+        void SubmitAndWait()
+        {
+            unsigned tail = *sqTail_; // Only this thread writes the tail
+            const unsigned head = std::atomic_ref<unsigned>(*sqHead_).load(std::memory_order_acquire);
+
+            // Don't queue more than the completion queue can hold
+            while (!pending_.empty() && tail - head < sqEntries_ && inKernel_ + unsubmitted_ < cqEntries_)
+            {
+                IoOperation &operation = *pending_.front();
+                pending_.pop_front();
+
+                const unsigned index = tail & sqMask_;
+                io_uring_sqe &sqe = sqes_[index];
+                std::memset(&sqe, 0, sizeof(sqe));
+
+                // READV rather than READ works on every kernel with io_uring (5.1+)
+                operation.Vector.iov_base = operation.Destination + operation.Done;
+                operation.Vector.iov_len = std::min(operation.Size - operation.Done, MaxReadSize);
+                sqe.opcode = IORING_OP_READV;
+                sqe.fd = operation.File;
+                sqe.off = operation.Offset + operation.Done;
+                sqe.addr = reinterpret_cast<uint64_t>(&operation.Vector);
+                sqe.len = 1;
+                sqe.user_data = reinterpret_cast<uint64_t>(&operation);
+
+                sqArray_[index] = index;
+                tail++;
+                unsubmitted_++;
+            }
+            std::atomic_ref<unsigned>(*sqTail_).store(tail, std::memory_order_release);
+
+            const unsigned waitFor = (inKernel_ + unsubmitted_ > 0) ? 1 : 0;
+            const long submitted = syscall(__NR_io_uring_enter, ringFd_, unsubmitted_, waitFor, IORING_ENTER_GETEVENTS, nullptr, 0);
+            if (submitted < 0)
+            {
+                if (errno != EINTR && errno != EAGAIN && errno != EBUSY)
+                    throw std::system_error(errno, std::generic_category(), "IoContext: io_uring_enter failed");
+            }
+            else
+            {
+                unsubmitted_ -= static_cast<unsigned>(submitted);
+                inKernel_ += static_cast<size_t>(submitted);
+            }
+
+            ReapCompletions();
+        }
+
+        void ReapCompletions()
+        {
+            unsigned head = *cqHead_; // Only this thread writes the head
+            const unsigned tail = std::atomic_ref<unsigned>(*cqTail_).load(std::memory_order_acquire);
+            while (head != tail)
+            {
+                const io_uring_cqe &cqe = cqes_[head & cqMask_];
+                IoOperation &operation = *reinterpret_cast<IoOperation *>(cqe.user_data);
+                const int result = cqe.res;
+                head++;
+                inKernel_--;
+
+                if (result == -EINTR || result == -EAGAIN)
+                {
+                    pending_.push_back(&operation);
+                }
+                else if (result < 0)
+                {
+                    operation.Error = -result;
+                    ready_.push_back(operation.Handle);
+                }
+                else if (result > 0 && operation.Done + static_cast<size_t>(result) < operation.Size)
+                {
+                    operation.Done += static_cast<size_t>(result);
+                    pending_.push_back(&operation); // Short read. Ask for the rest
+                }
+                else
+                {
+                    operation.Done += static_cast<size_t>(result);
+                    ready_.push_back(operation.Handle);
+                }
+            }
+            std::atomic_ref<unsigned>(*cqHead_).store(head, std::memory_order_release);
+        }
+
+        int ringFd_ = -1;
+        void *sqRing_ = nullptr;
+        void *cqRing_ = nullptr;
+        size_t sqRingSize_ = 0;
+        size_t cqRingSize_ = 0;
+        io_uring_sqe *sqes_ = nullptr;
+        size_t sqesSize_ = 0;
+        unsigned *sqHead_ = nullptr;
+        unsigned *sqTail_ = nullptr;
+        unsigned *sqArray_ = nullptr;
+        unsigned sqMask_ = 0;
+        unsigned sqEntries_ = 0;
+        unsigned *cqHead_ = nullptr;
+        unsigned *cqTail_ = nullptr;
+        io_uring_cqe *cqes_ = nullptr;
+        unsigned cqMask_ = 0;
+        unsigned cqEntries_ = 0;
+        unsigned unsubmitted_ = 0; // In the submission queue but not yet accepted by io_uring_enter
+#endif
+        size_t inKernel_ = 0; // Reads the kernel is working on
+        std::deque<IoOperation *> pending_;
+        std::deque<std::coroutine_handle<>> ready_;
+        std::exception_ptr exception_;
+    };
+
+    // Awaitable returned by the async read functions. Resumes with the number of bytes read, which is only less than
+    // the requested size at the end of the file. Throws std::system_error if the read fails.
+    class ReadOperation
+    {
+    public:
+        ReadOperation(IoContext &context, NativeFileHandle file, void *destination, size_t size, size_t offset)
+            : context_(&context)
+        {
+            operation_.File = file;
+            operation_.Destination = static_cast<uint8_t *>(destination);
+            operation_.Size = size;
+            operation_.Offset = offset;
+        }
+
+        bool await_ready() const noexcept
+        {
+            return operation_.Size == 0;
+        }
+
+        void await_suspend(std::coroutine_handle<> handle)
+        {
+            operation_.Handle = handle;
+            context_->Submit(operation_);
+        }
+
+        size_t await_resume() const
+        {
+            if (operation_.Error != 0)
+                throw std::system_error(operation_.Error, std::system_category(), "ReadOperation: Read failed");
+
+            return operation_.Done;
+        }
+
+    private:
+        IoContext *context_;
+        IoOperation operation_;
+    };
+
+    // File reader with awaitable reads. Any number of reads can be in flight at once, each into its own destination.
+    // ReadAsync() reads at the current position and advances it when the read is issued, not when it completes.
+    class AsyncFileReader
+    {
+    public:
+        // Throws std::runtime_error if the file can't be opened
+        AsyncFileReader(IoContext &context, std::string_view path)
+            : context_(&context)
+        {
+            const std::string pathString(path);
+#if defined(_WIN32)
+            file_ = CreateFileA(pathString.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+            LARGE_INTEGER size;
+            if (file_ == INVALID_HANDLE_VALUE || !GetFileSizeEx(file_, &size))
+            {
+                Close();
+                throw std::runtime_error("AsyncFileReader: Failed to open " + pathString);
+            }
+            length_ = static_cast<size_t>(size.QuadPart);
+#else
+            file_ = ::open(pathString.c_str(), O_RDONLY | O_CLOEXEC);
+            struct stat status;
+            if (file_ < 0 || ::fstat(file_, &status) != 0)
+            {
+                Close();
+                throw std::runtime_error("AsyncFileReader: Failed to open " + pathString);
+            }
+            length_ = static_cast<size_t>(status.st_size);
+#endif
+        }
+
+        AsyncFileReader(const AsyncFileReader &) = delete;
+        AsyncFileReader &operator=(const AsyncFileReader &) = delete;
+
+        // Reads still in flight must finish before the reader is destroyed
+        ~AsyncFileReader()
+        {
+            Close();
+        }
+
+        // co_await reader.ReadAsync(destination, size). Returns the number of bytes read
+        ReadOperation ReadAsync(void *destination, size_t size)
+        {
+            const size_t offset = position_;
+            position_ += size;
+            return ReadOperation(*context_, file_, destination, size, offset);
+        }
+
+        // co_await reader.ReadAtAsync(offset, destination, size). Doesn't change the position
+        ReadOperation ReadAtAsync(size_t absoluteOffset, void *destination, size_t size)
+        {
+            return ReadOperation(*context_, file_, destination, size, absoluteOffset);
+        }
+
+        void SeekBeg(size_t absoluteOffset)
+        {
+            position_ = absoluteOffset;
+        }
+
+        void SeekCur(size_t relativeOffset)
+        {
+            position_ += relativeOffset;
+        }
+
+        size_t Position() const
+        {
+            return position_;
+        }
+
+        // Length of the file when it was opened
+        size_t Length() const
+        {
+            return length_;
+        }
+
+        IoContext &Context()
+        {
+            return *context_;
+        }
+
+    private:
+        void Close()
+        {
+#if defined(_WIN32)
+            if (file_ != INVALID_HANDLE_VALUE)
+                CloseHandle(file_);
+            file_ = INVALID_HANDLE_VALUE;
+#else
+            if (file_ >= 0)
+                ::close(file_);
+            file_ = -1;
+#endif
+        }
+
+        IoContext *context_;
+#if defined(_WIN32)
+        NativeFileHandle file_ = INVALID_HANDLE_VALUE;
+#else
+        NativeFileHandle file_ = -1;
+#endif
+        size_t position_ = 0;
+        size_t length_ = 0;
+    };
+}
+
+#endif
@@ -0,0 +1,485 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+
+#include <binary_tools/Endian.hpp>
+#include <binary_tools/Simd.hpp>
+
+namespace binary_tools
+{
+    // Storage formats for mesh and animation attributes. Every format converts to and from float
+    enum class AttributeFormat
+    {
+        Float32,
+        Float16,         // IEEE 754 half precision
+        Snorm8,          // int8 mapped to [-1, 1]
+        Unorm8,          // uint8 mapped to [0, 1]
+        Snorm16,         // int16 mapped to [-1, 1]
+        Unorm16,         // uint16 mapped to [0, 1]
+        Snorm10_10_10_2, // One uint32 per element. x, y, z in bits 0-29 and w in bits 30-31, each mapped to [-1, 1]
+        Unorm10_10_10_2  // Same layout, each mapped to [0, 1]
+    };
+
+    inline bool IsPackedFormat(AttributeFormat format)
+    {
+        return format == AttributeFormat::Snorm10_10_10_2 || format == AttributeFormat::Unorm10_10_10_2;
+    }
+
+    // Size in bytes of one element with the given number of components. Packed formats are always 4 bytes.
+    // Throws std::invalid_argument unless components is 1 to 4
+    inline size_t AttributeSize(AttributeFormat format, size_t components)
+    {
+        if (components == 0 || components > 4)
+            throw std::invalid_argument("AttributeSize: Attributes must have 1 to 4 components");
+
+        switch (format)
+        {
+        case AttributeFormat::Float32:
+            return components * 4;
+        case AttributeFormat::Float16:
+        case AttributeFormat::Snorm16:
+        case AttributeFormat::Unorm16:
+            return components * 2;
+        case AttributeFormat::Snorm8:
+        case AttributeFormat::Unorm8:
+            return components;
+        default:
+            return 4;
+        }
+    }
+
+    // Exact conversion. Subnormals and infinities are preserved. NaNs keep their payload but are made quiet like F16C does
+    inline float HalfToFloat(uint16_t value)
+    {
+        const uint32_t sign = static_cast<uint32_t>(value & 0x8000) << 16;
+        uint32_t exponent = (value >> 10) & 0x1F;
+        uint32_t mantissa = value & 0x3FF;
+        uint32_t bits;
+        if (exponent == 0x1F)
+        {
+            bits = sign | 0x7F800000 | ((mantissa != 0 ? mantissa | 0x200 : 0) << 13);
+        }
+        else if (exponent != 0)
+        {
+            bits = sign | ((exponent + 112) << 23) | (mantissa << 13);
+        }
+        else if (mantissa == 0)
+        {
+            bits = sign;
+        }
+        else
+        {
+            // Subnormal half. Normalize it since every one of them is a normal float
+            exponent = 113;
+            while ((mantissa & 0x400) == 0)
+            {
+                mantissa <<= 1;
+                exponent--;
+            }
+            bits = sign | (exponent << 23) | ((mantissa & 0x3FF) << 13);
+        }
+
+        float output;
+        std::memcpy(&output, &bits, 4);
+        return output;
+    }
+
+    // Rounds to nearest even like F16C. Values too large for a half become infinity. NaNs become quiet NaNs with the top of the payload
+    inline uint16_t FloatToHalf(float value)
+    {
+        uint32_t bits;
+        std::memcpy(&bits, &value, 4);
+        const uint16_t sign = static_cast<uint16_t>((bits >> 16) & 0x8000);
+        bits &= 0x7FFFFFFF;
+
+        if (bits >= 0x47800000) // 65536 or larger, infinity or NaN
+            return sign | (bits > 0x7F800000 ? 0x7E00 | ((bits >> 13) & 0x3FF) : 0x7C00);
+
+        if (bits < 0x38800000) // Smaller than the smallest normal half. Let the FPU round the subnormal
+        {
+            float magnitude;
+            std::memcpy(&magnitude, &bits, 4);
+            magnitude += 0.5f;
+            uint32_t rounded;
+            std::memcpy(&rounded, &magnitude, 4);
+            return sign | static_cast<uint16_t>(rounded - 0x3F000000);
+        }
+
+        // Rebias the exponent and round the mantissa. A carry out of the mantissa correctly bumps the exponent
+        const uint32_t odd = (bits >> 13) & 1;
+        bits += 0xC8000FFF + odd; // ((15 - 127) << 23) + 0xFFF
+        return sign | static_cast<uint16_t>(bits >> 13);
+    }
+
+#pragma region Scalar conversion
+    // Clamps that behave like maxps/minps, so NaN handling matches the SIMD paths
+    inline float ClampAttribute(float value, float minimum, float maximum)
+    {
+        value = value > minimum ? value : minimum;
+        return value < maximum ? value : maximum;
+    }
+
+    // Convert count tightly packed values of a non packed format
+    inline void DecodeValues(const uint8_t *source, AttributeFormat format, size_t count, float *destination, bool swapBytes)
+    {
+        for (size_t i = 0; i < count; i++)
+        {
+            switch (format)
+            {
+            case AttributeFormat::Float32:
+            {
+                uint32_t bits;
+                std::memcpy(&bits, source + i * 4, 4);
+                bits = swapBytes ? ByteSwap32(bits) : bits;
+                std::memcpy(destination + i, &bits, 4);
+                break;
+            }
+            case AttributeFormat::Float16:
+            {
+                uint16_t bits;
+                std::memcpy(&bits, source + i * 2, 2);
+                destination[i] = HalfToFloat(swapBytes ? ByteSwap16(bits) : bits);
+                break;
+            }
+            case AttributeFormat::Snorm8:
+            {
+                const float value = static_cast<float>(static_cast<int8_t>(source[i])) * (1.0f / 127.0f);
+                destination[i] = value > -1.0f ? value : -1.0f;
+                break;
+            }
+            case AttributeFormat::Unorm8:
+                destination[i] = static_cast<float>(source[i]) * (1.0f / 255.0f);
+                break;
+            case AttributeFormat::Snorm16:
+            {
+                uint16_t bits;
+                std::memcpy(&bits, source + i * 2, 2);
+                const float value = static_cast<float>(static_cast<int16_t>(swapBytes ? ByteSwap16(bits) : bits)) * (1.0f / 32767.0f);
+                destination[i] = value > -1.0f ? value : -1.0f;
+                break;
+            }
+            case AttributeFormat::Unorm16:
+            {
+                uint16_t bits;
+                std::memcpy(&bits, source + i * 2, 2);
+                destination[i] = static_cast<float>(swapBytes ? ByteSwap16(bits) : bits) * (1.0f / 65535.0f);
+                break;
+            }
+            default:
+                break;
+            }
+        }
+    }
+
+    inline void EncodeValues(const float *source, AttributeFormat format, size_t count, uint8_t *destination, bool swapBytes)
+    {
+        for (size_t i = 0; i < count; i++)
+        {
+            switch (format)
+            {
+            case AttributeFormat::Float32:
+            {
+                uint32_t bits;
+                std::memcpy(&bits, source + i, 4);
+                bits = swapBytes ? ByteSwap32(bits) : bits;
+                std::memcpy(destination + i * 4, &bits, 4);
+                break;
+            }
+            case AttributeFormat::Float16:
+            {
+                const uint16_t bits = FloatToHalf(source[i]);
+                const uint16_t output = swapBytes ? ByteSwap16(bits) : bits;
+                std::memcpy(destination + i * 2, &output, 2);
+                break;
+            }
+            case AttributeFormat::Snorm8:
+                destination[i] = static_cast<uint8_t>(static_cast<int8_t>(std::nearbyint(ClampAttribute(source[i], -1.0f, 1.0f) * 127.0f)));
+                break;
+            case AttributeFormat::Unorm8:
+                destination[i] = static_cast<uint8_t>(std::nearbyint(ClampAttribute(source[i], 0.0f, 1.0f) * 255.0f));
+                break;
+            case AttributeFormat::Snorm16:
+            {
+                const uint16_t bits = static_cast<uint16_t>(static_cast<int16_t>(std::nearbyint(ClampAttribute(source[i], -1.0f, 1.0f) * 32767.0f)));
+                const uint16_t output = swapBytes ? ByteSwap16(bits) : bits;
+                std::memcpy(destination + i * 2, &output, 2);
+                break;
+            }
+            case AttributeFormat::Unorm16:
+            {
+                const uint16_t bits = static_cast<uint16_t>(std::nearbyint(ClampAttribute(source[i], 0.0f, 1.0f) * 65535.0f));
+                const uint16_t output = swapBytes ? ByteSwap16(bits) : bits;
+                std::memcpy(destination + i * 2, &output, 2);
+                break;
+            }
+            default:
+                break;
+            }
+        }
+    }
+
+    // Unpack a 10:10:10:2 word into x, y, z, w
+    inline void DecodePacked(uint32_t word, bool isSigned, float *output)
+    {
+        if (isSigned)
+        {
+            // Shift each field to the top of the word, then arithmetic shift back down to sign extend it
+            const int32_t x = static_cast<int32_t>(word << 22) >> 22;
+            const int32_t y = static_cast<int32_t>(word << 12) >> 22;
+            const int32_t z = static_cast<int32_t>(word << 2) >> 22;
+            const int32_t w = static_cast<int32_t>(word) >> 30;
+            const float values[4] = {x * (1.0f / 511.0f), y * (1.0f / 511.0f), z * (1.0f / 511.0f), static_cast<float>(w)};
+            for (size_t i = 0; i < 4; i++)
+                output[i] = values[i] > -1.0f ? values[i] : -1.0f;
+        }
+        else
+        {
+            output[0] = static_cast<float>(word & 0x3FF) * (1.0f / 1023.0f);
+            output[1] = static_cast<float>((word >> 10) & 0x3FF) * (1.0f / 1023.0f);
+            output[2] = static_cast<float>((word >> 20) & 0x3FF) * (1.0f / 1023.0f);
+            output[3] = static_cast<float>(word >> 30) * (1.0f / 3.0f);
+        }
+    }
+
+    // Pack x, y, z, w into a 10:10:10:2 word
+    inline uint32_t EncodePacked(const float *input, bool isSigned)
+    {
+        const float minimum = isSigned ? -1.0f : 0.0f;
+        const float scales[4] = {isSigned ? 511.0f : 1023.0f, isSigned ? 511.0f : 1023.0f, isSigned ? 511.0f : 1023.0f, isSigned ? 1.0f : 3.0f};
+        uint32_t word = 0;
+        for (size_t i = 0; i < 4; i++)
+        {
+            const int32_t value = static_cast<int32_t>(std::nearbyint(ClampAttribute(input[i], minimum, 1.0f) * scales[i]));
+            word |= (static_cast<uint32_t>(value) & (i < 3 ? 0x3FF : 0x3)) << (i * 10);
+        }
+        return word;
+    }
+#pragma endregion
+
+#pragma region Bulk conversion
+    // Convert count elements with `components` values each to floats.
+    // sourceStride is the distance in bytes between elements, e.g. the vertex size of an interleaved vertex buffer. 0 means tightly packed.
+    // destinationStride is the distance in floats between elements of destination. 0 means tightly packed.
+    // For packed formats components picks how many of x, y, z, w are written. swapBytes converts from the other byte order.
+    // Tightly packed data is converted 8 values at a time with F16C/AVX2. Strided halves and packed formats use SIMD per element.
+    inline void DecodeAttribute(const void *source, size_t sourceStride, AttributeFormat format, size_t components, size_t count,
+                                float *destination, size_t destinationStride = 0, bool swapBytes = false)
+    {
+        const size_t elementSize = AttributeSize(format, components);
+        sourceStride = sourceStride == 0 ? elementSize : sourceStride;
+        destinationStride = destinationStride == 0 ? components : destinationStride;
+        const uint8_t *input = static_cast<const uint8_t *>(source);
+
+        if (IsPackedFormat(format))
+        {
+            const bool isSigned = format == AttributeFormat::Snorm10_10_10_2;
+            for (size_t i = 0; i < count; i++)
+            {
+                uint32_t word;
+                std::memcpy(&word, input + i * sourceStride, 4);
+                word = swapBytes ? ByteSwap32(word) : word;
+                float *output = destination + i * destinationStride;
+#if defined(BINARY_TOOLS_AVX2)
+                // Variable shifts extract all four fields at once
+                const __m128i broadcast = _mm_set1_epi32(static_cast<int>(word));
+                __m128 values;
+                if (isSigned)
+                {
+                    const __m128i fields = _mm_srav_epi32(_mm_sllv_epi32(broadcast, _mm_setr_epi32(22, 12, 2, 0)), _mm_setr_epi32(22, 22, 22, 30));
+                    values = _mm_max_ps(_mm_mul_ps(_mm_cvtepi32_ps(fields), _mm_setr_ps(1.0f / 511.0f, 1.0f / 511.0f, 1.0f / 511.0f, 1.0f)), _mm_set1_ps(-1.0f));
+                }
+                else
+                {
+                    const __m128i fields = _mm_and_si128(_mm_srlv_epi32(broadcast, _mm_setr_epi32(0, 10, 20, 30)), _mm_setr_epi32(0x3FF, 0x3FF, 0x3FF, 0x3));
+                    values = _mm_mul_ps(_mm_cvtepi32_ps(fields), _mm_setr_ps(1.0f / 1023.0f, 1.0f / 1023.0f, 1.0f / 1023.0f, 1.0f / 3.0f));
+                }
+                if (components == 4)
+                {
+                    _mm_storeu_ps(output, values);
+                    continue;
+                }
+                float unpacked[4];
+                _mm_storeu_ps(unpacked, values);
+#else
+                float unpacked[4];
+                DecodePacked(word, isSigned, unpacked);
+#endif
+                std::memcpy(output, unpacked, components * sizeof(float));
+            }
+            return;
+        }
+
+        if (sourceStride != elementSize || destinationStride != components || swapBytes)
+        {
+            for (size_t i = 0; i < count; i++)
+            {
+                const uint8_t *element = input + i * sourceStride;
+                float *output = destination + i * destinationStride;
+#if defined(BINARY_TOOLS_F16C)
+                // Scalar half conversion is slow enough that converting one element per instruction is still a win
+                if (format == AttributeFormat::Float16 && !swapBytes)
+                {
+                    uint64_t halves = 0;
+                    std::memcpy(&halves, element, elementSize);
+                    const __m128 values = _mm_cvtph_ps(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(&halves)));
+                    if (components == 4)
+                    {
+                        _mm_storeu_ps(output, values);
+                    }
+                    else
+                    {
+                        float converted[4];
+                        _mm_storeu_ps(converted, values);
+                        std::memcpy(output, converted, components * sizeof(float));
+                    }
+                    continue;
+                }
+#endif
+                DecodeValues(element, format, components, output, swapBytes);
+            }
+            return;
+        }
+
+        // Tightly packed. Treat it as one flat array of values
+        const size_t valueCount = count * components;
+        size_t i = 0;
+        switch (format)
+        {
+        case AttributeFormat::Float32:
+            std::memcpy(destination, input, valueCount * 4);
+            return;
+#if defined(BINARY_TOOLS_F16C)
+        case AttributeFormat::Float16:
+            for (; i + 8 <= valueCount; i += 8)
+                _mm256_storeu_ps(destination + i, _mm256_cvtph_ps(_mm_loadu_si128(reinterpret_cast<const __m128i *>(input + i * 2))));
+            break;
+#endif
+#if defined(BINARY_TOOLS_AVX2)
+        case AttributeFormat::Snorm8:
+            for (; i + 8 <= valueCount; i += 8)
+            {
+                const __m256 values = _mm256_cvtepi32_ps(_mm256_cvtepi8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(input + i))));
+                _mm256_storeu_ps(destination + i, _mm256_max_ps(_mm256_mul_ps(values, _mm256_set1_ps(1.0f / 127.0f)), _mm256_set1_ps(-1.0f)));
+            }
+            break;
+        case AttributeFormat::Unorm8:
+            for (; i + 8 <= valueCount; i += 8)
+            {
+                const __m256 values = _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(input + i))));
+                _mm256_storeu_ps(destination + i, _mm256_mul_ps(values, _mm256_set1_ps(1.0f / 255.0f)));
+            }
+            break;
+        case AttributeFormat::Snorm16:
+            for (; i + 8 <= valueCount; i += 8)
+            {
+                const __m256 values = _mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i *>(input + i * 2))));
+                _mm256_storeu_ps(destination + i, _mm256_max_ps(_mm256_mul_ps(values, _mm256_set1_ps(1.0f / 32767.0f)), _mm256_set1_ps(-1.0f)));
+            }
+            break;
+        case AttributeFormat::Unorm16:
+            for (; i + 8 <= valueCount; i += 8)
+            {
+                const __m256 values = _mm256_cvtepi32_ps(_mm256_cvtepu16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i *>(input + i * 2))));
+                _mm256_storeu_ps(destination + i, _mm256_mul_ps(values, _mm256_set1_ps(1.0f / 65535.0f)));
+            }
+            break;
+#endif
+        default:
+            break;
+        }
+
+        // Remainder, or everything without SIMD
+        const size_t valueSize = AttributeSize(format, 1);
+        DecodeValues(input + i * valueSize, format, valueCount - i, destination + i, false);
+    }
+
+    // Convert count elements of `components` floats each to format. The inverse of DecodeAttribute() with the same stride rules.
+    // Values are clamped to the format's range and rounded to nearest even. For packed formats missing components are stored as zero.
+    inline void EncodeAttribute(const float *source, size_t sourceStride, AttributeFormat format, size_t components, size_t count,
+                                void *destination, size_t destinationStride = 0, bool swapBytes = false)
+    {
+        const size_t elementSize = AttributeSize(format, components);
+        sourceStride = sourceStride == 0 ? components : sourceStride;
+        destinationStride = destinationStride == 0 ? elementSize : destinationStride;
+        uint8_t *output = static_cast<uint8_t *>(destination);
+
+        if (IsPackedFormat(format))
+        {
+            const bool isSigned = format == AttributeFormat::Snorm10_10_10_2;
+            for (size_t i = 0; i < count; i++)
+            {
+                float values[4] = {};
+                std::memcpy(values, source + i * sourceStride, components * sizeof(float));
+                const uint32_t word = EncodePacked(values, isSigned);
+                const uint32_t swapped = swapBytes ? ByteSwap32(word) : word;
+                std::memcpy(output + i * destinationStride, &swapped, 4);
+            }
+            return;
+        }
+
+        if (sourceStride != components || destinationStride != elementSize || swapBytes)
+        {
+            for (size_t i = 0; i < count; i++)
+                EncodeValues(source + i * sourceStride, format, components, output + i * destinationStride, swapBytes);
+            return;
+        }
+
+        const size_t valueCount = count * components;
+        size_t i = 0;
+        switch (format)
+        {
+        case AttributeFormat::Float32:
+            std::memcpy(output, source, valueCount * 4);
+            return;
+#if defined(BINARY_TOOLS_F16C)
+        case AttributeFormat::Float16:
+            for (; i + 8 <= valueCount; i += 8)
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(output + i * 2), _mm256_cvtps_ph(_mm256_loadu_ps(source + i), _MM_FROUND_TO_NEAREST_INT));
+            break;
+#endif
+#if defined(BINARY_TOOLS_AVX2)
+        case AttributeFormat::Snorm8:
+        case AttributeFormat::Unorm8:
+        case AttributeFormat::Snorm16:
+        case AttributeFormat::Unorm16:
+        {
+            const bool isSigned = format == AttributeFormat::Snorm8 || format == AttributeFormat::Snorm16;
+            const float scale = format == AttributeFormat::Snorm8 ? 127.0f : format == AttributeFormat::Unorm8 ? 255.0f : format == AttributeFormat::Snorm16 ? 32767.0f : 65535.0f;
+            const __m256 minimum = _mm256_set1_ps(isSigned ? -1.0f : 0.0f);
+            const __m256 maximum = _mm256_set1_ps(1.0f);
+            const __m256 scales = _mm256_set1_ps(scale);
+            for (; i + 8 <= valueCount; i += 8)
+            {
+                const __m256 clamped = _mm256_min_ps(_mm256_max_ps(_mm256_loadu_ps(source + i), minimum), maximum);
+                const __m256i rounded = _mm256_cvtps_epi32(_mm256_mul_ps(clamped, scales));
+                const __m128i low = _mm256_castsi256_si128(rounded);
+                const __m128i high = _mm256_extracti128_si256(rounded, 1);
+                if (format == AttributeFormat::Unorm16)
+                {
+                    _mm_storeu_si128(reinterpret_cast<__m128i *>(output + i * 2), _mm_packus_epi32(low, high));
+                    continue;
+                }
+
+                const __m128i words = _mm_packs_epi32(low, high);
+                if (format == AttributeFormat::Snorm16)
+                    _mm_storeu_si128(reinterpret_cast<__m128i *>(output + i * 2), words);
+                else if (format == AttributeFormat::Snorm8)
+                    _mm_storel_epi64(reinterpret_cast<__m128i *>(output + i), _mm_packs_epi16(words, words));
+                else
+                    _mm_storel_epi64(reinterpret_cast<__m128i *>(output + i), _mm_packus_epi16(words, words));
+            }
+            break;
+        }
+#endif
+        default:
+            break;
+        }
+
+        const size_t valueSize = AttributeSize(format, 1);
+        EncodeValues(source + i, format, valueCount - i, output + i * valueSize, false);
+    }
+#pragma endregion
+}
@@ -0,0 +1,866 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <binary_tools/AttributeFormats.hpp>
+#include <binary_tools/Endian.hpp>
+#include <binary_tools/Search.hpp>
+#include <binary_tools/Utf16.hpp>
+
+namespace binary_tools
+{
+    // Bounds checking policies for BasicBinaryReader.
+    // Unchecked: Short reads return zero. Nothing is recorded. Like a stream, a short read still consumes the bytes that were left.
+    // Checked: Short reads return zero and set a sticky error flag. Once set every following read fails as well,
+    //          so a parser can read a whole structure and check HasError() once at the end. Never throws.
+    struct Unchecked
+    {
+        static constexpr bool Enabled = false;
+    };
+
+    struct Checked
+    {
+        static constexpr bool Enabled = true;
+    };
+
+    // Binary reader with the data source, byte order and bounds checking chosen at compile time.
+    // Nothing is virtual, so parsers written against a concrete source inline completely.
+    // See ReaderSources.hpp for the source interface. BinaryReader, CheckedBinaryReader and BinaryStreamReader are aliases of this.
+    template <class Source, class Endian = NativeEndian, class Checking = Unchecked>
+    class BasicBinaryReader
+    {
+    public:
+        // Constructor arguments are forwarded to the source. E.g. a path for StreamSource or a buffer and size for MemorySource.
+        // Explicit so a path or buffer never silently converts into a reader (e.g. opening a file)
+        template <typename... Args, typename = std::enable_if_t<std::is_constructible<Source, Args &&...>::value>>
+        explicit BasicBinaryReader(Args &&...args)
+            : source_(std::forward<Args>(args)...)
+        {
+        }
+
+        BasicBinaryReader(const BasicBinaryReader &) = delete;
+        BasicBinaryReader &operator=(const BasicBinaryReader &) = delete;
+
+        Source &GetSource()
+        {
+            return source_;
+        }
+
+        const Source &GetSource() const
+        {
+            return source_;
+        }
+
+        // Point the reader at new data, reusing the source's resources. Arguments are forwarded to the source's Reset().
+        // Also clears the error flag
+        template <typename... Args>
+        void Reset(Args &&...args)
+        {
+            source_.Reset(std::forward<Args>(args)...);
+            error_ = false;
+        }
+
+#pragma region Error state
+        // True if any read, seek or Ensure() went past the end of the data. Always false for Unchecked readers
+        bool HasError() const
+        {
+            if constexpr (Checking::Enabled)
+                return error_;
+            else
+                return false;
+        }
+
+        // Check that size more bytes can be read. In checked mode this also sets the error flag when they can't.
+        // For contiguous sources the next size bytes can then be read with ReadUnchecked<T>().
+        bool Ensure(size_t size)
+        {
+            if (HasError() || !source_.CanRead(size))
+            {
+                Fail();
+                return false;
+            }
+            return true;
+        }
+#pragma endregion
+
+#pragma region Unsigned integers
+        [[nodiscard]] uint8_t ReadUint8()
+        {
+            return Read<uint8_t>();
+        }
+
+        [[nodiscard]] uint16_t ReadUint16()
+        {
+            return Read<uint16_t>();
+        }
+
+        [[nodiscard]] uint32_t ReadUint32()
+        {
+            return Read<uint32_t>();
+        }
+
+        [[nodiscard]] uint64_t ReadUint64()
+        {
+            return Read<uint64_t>();
+        }
+#pragma endregion
+
+#pragma region Signed integers
+        [[nodiscard]] int8_t ReadInt8()
+        {
+            return Read<int8_t>();
+        }
+
+        [[nodiscard]] int16_t ReadInt16()
+        {
+            return Read<int16_t>();
+        }
+
+        [[nodiscard]] int32_t ReadInt32()
+        {
+            return Read<int32_t>();
+        }
+
+        [[nodiscard]] int64_t ReadInt64()
+        {
+            return Read<int64_t>();
+        }
+#pragma endregion
+
+        [[nodiscard]] bool ReadBoolean()
+        {
+            return this->ReadUint8() != 0;
+        }
+
+#pragma region Bytes
+        [[nodiscard]] uint8_t ReadByte()
+        {
+            return this->ReadUint8();
+        }
+
+        [[nodiscard]] std::vector<uint8_t> ReadBytes(size_t count)
+        {
+            std::vector<uint8_t> output(count);
+            if (ReadToMemory(output.data(), count) != count && Checking::Enabled)
+                output.clear();
+
+            return output;
+        }
+#pragma endregion
+
+#pragma region Characters
+        [[nodiscard]] char ReadChar()
+        {
+            return Read<char>();
+        }
+
+        [[nodiscard]] wchar_t ReadCharWide()
+        {
+            return static_cast<wchar_t>(Read<uint16_t>());
+        }
+
+        // In checked mode a missing null terminator returns an empty string and sets the error flag
+        [[nodiscard]] std::string ReadNullTerminatedString()
+        {
+            std::string output;
+            if (HasError())
+                return output;
+
+            if constexpr (Source::IsContiguous)
+            {
+                const uint8_t *begin = source_.Current();
+                const size_t remaining = source_.Remaining();
+                const uint8_t *terminator = remaining > 0 ? static_cast<const uint8_t *>(std::memchr(begin, '\0', remaining)) : nullptr;
+                if (terminator)
+                {
+                    output.assign(reinterpret_cast<const char *>(begin), terminator - begin);
+                    source_.Advance((terminator - begin) + 1); // Move past null terminator
+                    return output;
+                }
+
+                if constexpr (!Checking::Enabled)
+                    output.assign(reinterpret_cast<const char *>(begin), remaining);
+                source_.Advance(remaining);
+                Fail();
+            }
+            else
+            {
+                // Search what already arrived a chunk at a time instead of peeking each character.
+                // PeekSome() doesn't wait for a full chunk, so a string is returned as soon as its terminator arrives
+                char chunk[StringChunkSize];
+                while (true)
+                {
+                    const size_t count = source_.PeekSome(chunk, sizeof(chunk));
+                    if (count == 0)
+                    {
+                        Fail();
+                        if constexpr (Checking::Enabled)
+                            output.clear();
+                        break;
+                    }
+
+                    const char *terminator = static_cast<const char *>(std::memchr(chunk, '\0', count));
+                    if (terminator)
+                    {
+                        output.append(chunk, terminator - chunk);
+                        source_.Skip((terminator - chunk) + 1); // Move past null terminator
+                        break;
+                    }
+
+                    output.append(chunk, count);
+                    source_.Skip(count);
+                }
+            }
+            return output;
+        }
+
+        [[nodiscard]] std::string ReadFixedLengthString(size_t length)
+        {
+            std::string output(length, '\0');
+            if (ReadToMemory(output.data(), length) != length && Checking::Enabled)
+                output.clear();
+
+            return output;
+        }
+
+        // Reads UTF-16. wchar_t is 4 bytes on Linux, so surrogate pairs are combined into one character there. See U16StringToWString()
+        [[nodiscard]] std::wstring ReadNullTerminatedStringWide()
+        {
+            return U16StringToWString(ReadNullTerminatedUtf16String());
+        }
+
+        // length is in 16 bit code units, so the result is shorter than length when surrogate pairs are combined
+        [[nodiscard]] std::wstring ReadFixedLengthStringWide(size_t length)
+        {
+            return U16StringToWString(ReadFixedLengthUtf16String(length));
+        }
+
+        [[nodiscard]] std::vector<std::string> ReadSizedStringList(size_t listSize)
+        {
+            std::vector<std::string> stringList = {};
+            if (listSize == 0)
+                return stringList;
+
+            size_t startPos = Position();
+            while (Position() - startPos < listSize && !EndOfStream() && !HasError())
+            {
+                stringList.push_back(ReadNullTerminatedString());
+                while (Position() - startPos < listSize)
+                {
+                    // Some formats (e.g. RFG sized string lists) pad names with a varying number of null bytes.
+                    // Skip them one at a time since the padding doesn't end on a fixed alignment that Align() could use
+                    if (!EndOfStream() && PeekChar() == '\0')
+                        Skip(1);
+                    else
+                        break;
+                }
+            }
+
+            return stringList;
+        }
+#pragma endregion
+
+#pragma region UTF-16
+        // UTF-16 strings are stored in the reader's byte order. E.g. a BigEndian reader reads UTF-16BE.
+        // Lengths are in code units. The terminator search and ASCII transcoding use SSE2/AVX2 when available.
+        [[nodiscard]] char16_t ReadChar16()
+        {
+            return static_cast<char16_t>(Read<uint16_t>());
+        }
+
+        [[nodiscard]] std::u16string ReadNullTerminatedUtf16String()
+        {
+            return ReadNullTerminatedUtf16<std::u16string>(&Utf16ToU16String);
+        }
+
+        [[nodiscard]] std::u16string ReadFixedLengthUtf16String(size_t length)
+        {
+            return ReadFixedLengthUtf16<std::u16string>(length, &Utf16ToU16String);
+        }
+
+        // Reads a null terminated UTF-16 string and transcodes it to UTF-8
+        [[nodiscard]] std::string ReadNullTerminatedUtf16StringAsUtf8()
+        {
+            return ReadNullTerminatedUtf16<std::string>(&Utf16ToUtf8);
+        }
+
+        // Reads length UTF-16 code units and transcodes them to UTF-8
+        [[nodiscard]] std::string ReadFixedLengthUtf16StringAsUtf8(size_t length)
+        {
+            return ReadFixedLengthUtf16<std::string>(length, &Utf16ToUtf8);
+        }
+#pragma endregion
+
+#pragma region Peek
+        [[nodiscard]] char PeekChar()
+        {
+            return Peek<char>();
+        }
+
+        [[nodiscard]] wchar_t PeekCharWide()
+        {
+            return static_cast<wchar_t>(Peek<uint16_t>());
+        }
+
+        [[nodiscard]] uint32_t PeekUint32()
+        {
+            return Peek<uint32_t>();
+        }
+
+        // Copy the next size bytes to destination without moving. Returns the number of bytes copied
+        size_t PeekToMemory(void *destination, size_t size)
+        {
+            const size_t count = source_.Peek(destination, size);
+            if (count < size)
+                std::memset(static_cast<char *>(destination) + count, 0, size - count);
+
+            return count;
+        }
+
+        template <typename T>
+        [[nodiscard]] T Peek()
+        {
+            static_assert(std::is_trivially_copyable<T>(), "BasicBinaryReader::Peek<T> requires T to be trivially copyable.");
+            T output{};
+            if (HasError())
+                return output;
+
+            if constexpr (Source::IsContiguous)
+            {
+                if (source_.Remaining() < sizeof(T))
+                {
+                    Fail();
+                    return output;
+                }
+                std::memcpy(&output, source_.Current(), sizeof(T));
+            }
+            else
+            {
+                if (source_.Peek(&output, sizeof(T)) < sizeof(T))
+                {
+                    Fail();
+                    return T{};
+                }
+            }
+            return ConvertEndian(output);
+        }
+#pragma endregion
+
+#pragma region Floating point
+        [[nodiscard]] float ReadFloat()
+        {
+            return Read<float>();
+        }
+
+        [[nodiscard]] double ReadDouble()
+        {
+            return Read<double>();
+        }
+
+        // Read a half precision float
+        [[nodiscard]] float ReadHalf()
+        {
+            return HalfToFloat(Read<uint16_t>());
+        }
+#pragma endregion
+
+#pragma region Attributes
+        // Read count elements of format and convert them to floats.
+        // sourceStride is the distance in bytes between elements, e.g. the vertex size to read one attribute out of interleaved vertices.
+        // destinationStride is the distance in floats between elements of destination. 0 means tightly packed for both.
+        // Strides smaller than an element (AttributeSize() bytes or components floats) are rejected.
+        // (count - 1) * sourceStride + element size bytes are read, so the position ends just after the last element's attribute.
+        // Returns false and zeroes destination if a stride is invalid or the data ends first.
+        // components must be 1 to 4. Checked readers fail and return false without touching destination, unchecked readers throw like AttributeSize()
+        bool ReadAttribute(AttributeFormat format, size_t components, size_t count, float *destination, size_t sourceStride = 0, size_t destinationStride = 0)
+        {
+            if constexpr (Checking::Enabled)
+            {
+                if (components == 0 || components > 4)
+                {
+                    Fail();
+                    return false;
+                }
+            }
+            if (count == 0)
+                return !HasError();
+
+            const size_t elementSize = AttributeSize(format, components);
+            sourceStride = sourceStride == 0 ? elementSize : sourceStride;
+            destinationStride = destinationStride == 0 ? components : destinationStride;
+            const size_t size = (count - 1) * sourceStride + elementSize;
+            const bool validStrides = sourceStride >= elementSize && destinationStride >= components;
+            if constexpr (Source::IsContiguous)
+            {
+                // Converted straight out of the source
+                if (validStrides && source_.Remaining() >= size)
+                {
+                    DecodeAttribute(source_.Current(), sourceStride, format, components, count, destination, destinationStride, !Endian::IsNative);
+                    source_.Advance(size);
+                    return true;
+                }
+                if (validStrides)
+                    source_.Advance(source_.Remaining()); // Consume the partial data like Read<T>()
+            }
+            else if (validStrides && !HasError())
+            {
+                // Convert a chunk of elements at a time
+                const size_t chunkElements = std::max<size_t>(1, AttributeChunkSize / sourceStride);
+                std::vector<uint8_t> chunk(std::min(size, chunkElements * sourceStride));
+                size_t done = 0;
+                while (done < count)
+                {
+                    const size_t elements = std::min(chunkElements, count - done);
+                    const size_t bytes = done + elements == count ? (elements - 1) * sourceStride + elementSize : elements * sourceStride;
+                    if (source_.Read(chunk.data(), bytes) != bytes)
+                        break;
+
+                    DecodeAttribute(chunk.data(), sourceStride, format, components, elements, destination + done * destinationStride, destinationStride, !Endian::IsNative);
+                    done += elements;
+                }
+                if (done == count)
+                    return true;
+            }
+
+            for (size_t i = 0; i < count; i++)
+                std::fill_n(destination + i * destinationStride, components, 0.0f);
+
+            Fail();
+            return false;
+        }
+#pragma endregion
+
+#pragma region Memory
+        // Copy size raw bytes into destination. Returns the number of bytes read. Bytes past the end of the data are zeroed
+        size_t ReadToMemory(void *destination, size_t size)
+        {
+            size_t count = 0;
+            if (!HasError())
+            {
+                if constexpr (Source::IsContiguous)
+                {
+                    count = std::min(size, source_.Remaining());
+                    if (count > 0)
+                        std::memcpy(destination, source_.Current(), count);
+                    source_.Advance(count);
+                }
+                else
+                {
+                    count = source_.Read(destination, size);
+                }
+            }
+
+            if (count < size)
+            {
+                std::memset(static_cast<char *>(destination) + count, 0, size - count);
+                Fail();
+            }
+            return count;
+        }
+
+        // Read any trivially copyable type. Integers, floats and enums are converted from the reader's byte order.
+        // Returns a value initialized T if the data ends first.
+        template <typename T>
+        [[nodiscard]] T Read()
+        {
+            static_assert(std::is_trivially_copyable<T>(), "BasicBinaryReader::Read<T> requires T to be trivially copyable.");
+            T output{};
+            if constexpr (Source::IsContiguous)
+            {
+                // No HasError() check needed. Failing moves contiguous sources to the end so this check fails too
+                if (source_.Remaining() < sizeof(T))
+                {
+                    source_.Advance(source_.Remaining()); // Otherwise EndOfStream() never becomes true on a truncated value
+                    Fail();
+                    return output;
+                }
+                std::memcpy(&output, source_.Current(), sizeof(T));
+                source_.Advance(sizeof(T));
+            }
+            else
+            {
+                if (HasError())
+                    return output;
+
+                if (source_.Read(&output, sizeof(T)) < sizeof(T))
+                {
+                    Fail();
+                    return T{};
+                }
+            }
+            return ConvertEndian(output);
+        }
+
+        // Read without a bounds check. Only valid for bytes already covered by a successful Ensure()
+        template <typename T>
+        [[nodiscard]] T ReadUnchecked()
+        {
+            static_assert(Source::IsContiguous, "BasicBinaryReader::ReadUnchecked<T> requires a contiguous source.");
+            static_assert(std::is_trivially_copyable<T>(), "BasicBinaryReader::ReadUnchecked<T> requires T to be trivially copyable.");
+            assert(source_.Remaining() >= sizeof(T));
+            T output;
+            std::memcpy(&output, source_.Current(), sizeof(T));
+            source_.Advance(sizeof(T));
+            return ConvertEndian(output);
+        }
+
+        // Read a value or std::nullopt if the data ends first. The error flag is still set on failure
+        template <typename T>
+        [[nodiscard]] std::optional<T> TryRead()
+        {
+            static_assert(Checking::Enabled, "BasicBinaryReader::TryRead<T> requires the Checked policy.");
+            T output = Read<T>();
+            if (HasError())
+                return std::nullopt;
+
+            return output;
+        }
+
+        [[nodiscard]] std::optional<std::string> TryReadNullTerminatedString()
+        {
+            static_assert(Checking::Enabled, "BasicBinaryReader::TryReadNullTerminatedString requires the Checked policy.");
+            std::string output = ReadNullTerminatedString();
+            if (HasError())
+                return std::nullopt;
+
+            return output;
+        }
+
+        [[nodiscard]] std::optional<std::string> TryReadFixedLengthString(size_t length)
+        {
+            static_assert(Checking::Enabled, "BasicBinaryReader::TryReadFixedLengthString requires the Checked policy.");
+            std::string output = ReadFixedLengthString(length);
+            if (HasError())
+                return std::nullopt;
+
+            return output;
+        }
+#pragma endregion
+
+#pragma region Search
+        // The search functions scan from the current position to the end of the data and return absolute offsets.
+        // They don't move the reader. Contiguous sources are searched in place. Other sources are streamed a chunk at a time.
+
+        // Returns the offset of the next occurrence of bytes. An empty pattern is never found
+        [[nodiscard]] std::optional<size_t> Find(const void *bytes, size_t size)
+        {
+            if (size == 0)
+                return std::nullopt;
+
+            const uint8_t *needle = static_cast<const uint8_t *>(bytes);
+            size_t result = NotFound;
+            ScanChunks(size - 1, [&](const uint8_t *data, size_t dataSize, size_t dataOffset)
+                       {
+                           const size_t match = FindBytes(data, dataSize, needle, size);
+                           if (match == NotFound)
+                               return true;
+
+                           result = dataOffset + match;
+                           return false; });
+
+            return ToOptional(result);
+        }
+
+        [[nodiscard]] std::optional<size_t> Find(std::string_view bytes)
+        {
+            return Find(bytes.data(), bytes.size());
+        }
+
+        // Returns the offsets of every occurrence of bytes, including ones that overlap. An empty pattern returns no offsets
+        [[nodiscard]] std::vector<size_t> FindAll(const void *bytes, size_t size)
+        {
+            std::vector<size_t> results;
+            if (size == 0)
+                return results;
+
+            const uint8_t *needle = static_cast<const uint8_t *>(bytes);
+            ScanChunks(size - 1, [&](const uint8_t *data, size_t dataSize, size_t dataOffset)
+                       {
+                           size_t start = 0;
+                           while (start < dataSize)
+                           {
+                               const size_t match = FindBytes(data + start, dataSize - start, needle, size);
+                               if (match == NotFound)
+                                   break;
+
+                               results.push_back(dataOffset + start + match);
+                               start += match + 1;
+                           }
+                           return true; });
+
+            return results;
+        }
+
+        [[nodiscard]] std::vector<size_t> FindAll(std::string_view bytes)
+        {
+            return FindAll(bytes.data(), bytes.size());
+        }
+
+        // Returns the offset of the next value that starts at a multiple of alignment. The value is converted to the reader's byte order first.
+        // E.g. FindNext<uint32_t>(0x46464952, 4) finds the next 4 byte aligned "RIFF" signature.
+        template <typename T>
+        [[nodiscard]] std::optional<size_t> FindNext(const T &value, size_t alignment = sizeof(T))
+        {
+            static_assert(std::is_trivially_copyable<T>(), "BasicBinaryReader::FindNext<T> requires T to be trivially copyable.");
+            const T converted = ConvertEndian(value);
+            uint8_t bytes[sizeof(T)];
+            std::memcpy(bytes, &converted, sizeof(T));
+
+            size_t result = NotFound;
+            ScanChunks(sizeof(T) - 1, [&](const uint8_t *data, size_t dataSize, size_t dataOffset)
+                       {
+                           const size_t match = FindAligned(data, dataSize, dataOffset, bytes, sizeof(T), alignment);
+                           if (match == NotFound)
+                               return true;
+
+                           result = dataOffset + match;
+                           return false; });
+
+            return ToOptional(result);
+        }
+#pragma endregion
+
+#pragma region Seek
+        // Seeking doesn't clear the error flag. A checked reader stays failed once it has failed
+        void SeekBeg(size_t absoluteOffset)
+        {
+            if (HasError())
+                return;
+
+            if (!source_.Seek(absoluteOffset))
+                Fail();
+        }
+
+        void SeekCur(size_t relativeOffset)
+        {
+            Skip(relativeOffset);
+        }
+
+        // Move to relativeOffset bytes before the end of the data
+        void SeekEnd(size_t relativeOffset)
+        {
+            const size_t length = Length();
+            SeekBeg(length - std::min(length, relativeOffset));
+        }
+
+        // Move backwards from the current stream position
+        void SeekReverse(size_t relativeOffset)
+        {
+            const size_t delta = std::min(Position(), relativeOffset); // Don't allow seeking before the beginning of the stream
+            const size_t targetOffset = Position() - delta;
+            SeekBeg(targetOffset);
+        }
+
+        // Returns the number of bytes skipped. Less than bytesToSkip if the data ends first
+        size_t Skip(size_t bytesToSkip)
+        {
+            if (HasError())
+                return 0;
+
+            const size_t skipped = source_.Skip(bytesToSkip);
+            if (skipped < bytesToSkip)
+                Fail();
+            return skipped;
+        }
+#pragma endregion
+
+#pragma region Alignment
+        size_t Align(size_t alignmentValue = 2048)
+        {
+            const size_t remainder = Position() % alignmentValue;
+            size_t paddingSize = remainder > 0 ? alignmentValue - remainder : 0;
+            Skip(paddingSize);
+            return paddingSize;
+        }
+#pragma endregion
+
+#pragma region Position and length
+        size_t Position() const
+        {
+            return source_.Position();
+        }
+
+        size_t Length()
+        {
+            return source_.Length();
+        }
+
+        // True once all data has been read. For streaming sources this may block until more data arrives
+        bool EndOfStream()
+        {
+            return HasError() || source_.EndOfStream();
+        }
+#pragma endregion
+
+    protected:
+        static constexpr size_t StringChunkSize = 256;
+        static constexpr size_t AttributeChunkSize = 64 * 1024;
+        static constexpr size_t SearchChunkSize = 1024 * 1024;
+
+        static std::optional<size_t> ToOptional(size_t offset)
+        {
+            if (offset == NotFound)
+                return std::nullopt;
+
+            return offset;
+        }
+
+        // Calls scan(data, size, absoluteOffset) on the data from the current position to the end, then restores the position.
+        // Chunks after the first start with the last `overlap` bytes of the previous one so matches can't be split between chunks.
+        // scan returns false to stop early.
+        template <typename Scan>
+        void ScanChunks(size_t overlap, Scan &&scan)
+        {
+            static_assert(Source::IsSeekable, "BasicBinaryReader search functions require a seekable source.");
+            if (HasError())
+                return;
+
+            if constexpr (Source::IsContiguous)
+            {
+                scan(source_.Current(), source_.Remaining(), source_.Position());
+            }
+            else
+            {
+                const size_t start = source_.Position();
+                std::vector<uint8_t> buffer(SearchChunkSize + overlap);
+                size_t carried = 0;
+                size_t bufferOffset = start;
+                while (true)
+                {
+                    const size_t count = source_.Read(buffer.data() + carried, SearchChunkSize);
+                    if (count == 0)
+                        break;
+
+                    const size_t size = carried + count;
+                    if (!scan(buffer.data(), size, bufferOffset))
+                        break;
+
+                    carried = std::min(overlap, size);
+                    std::memmove(buffer.data(), buffer.data() + size - carried, carried);
+                    bufferOffset += size - carried;
+                }
+                source_.Seek(start);
+            }
+        }
+
+        // Find the UTF-16 terminator, decode the code units before it and move past it
+        template <typename Output>
+        Output ReadNullTerminatedUtf16(Output (*decode)(const uint8_t *, size_t, bool))
+        {
+            constexpr bool swap = !Endian::IsNative;
+            if (HasError())
+                return Output{};
+
+            if constexpr (Source::IsContiguous)
+            {
+                const uint8_t *begin = source_.Current();
+                const size_t maxUnits = source_.Remaining() / 2;
+                const size_t length = FindUtf16Terminator(begin, maxUnits);
+                if (length < maxUnits)
+                {
+                    Output output = decode(begin, length, swap);
+                    source_.Advance(length * 2 + 2); // Move past null terminator
+                    return output;
+                }
+
+                Output output = Checking::Enabled ? Output{} : decode(begin, maxUnits, swap);
+                source_.Advance(source_.Remaining());
+                Fail();
+                return output;
+            }
+            else
+            {
+                // Collect the raw code units a chunk at a time so surrogate pairs split across chunks decode correctly
+                std::string raw;
+                uint8_t chunk[StringChunkSize];
+                while (true)
+                {
+                    // Only wait for data when less than one code unit is buffered
+                    size_t count = source_.PeekSome(chunk, sizeof(chunk));
+                    if (count == 1)
+                        count = source_.Peek(chunk, 2);
+                    count &= ~size_t(1);
+                    if (count == 0)
+                    {
+                        Fail();
+                        if constexpr (Checking::Enabled)
+                            return Output{};
+                        break;
+                    }
+
+                    const size_t units = count / 2;
+                    const size_t length = FindUtf16Terminator(chunk, units);
+                    raw.append(reinterpret_cast<const char *>(chunk), length * 2);
+                    if (length < units)
+                    {
+                        source_.Skip(length * 2 + 2); // Move past null terminator
+                        break;
+                    }
+                    source_.Skip(count);
+                }
+                return decode(reinterpret_cast<const uint8_t *>(raw.data()), raw.size() / 2, swap);
+            }
+        }
+
+        template <typename Output>
+        Output ReadFixedLengthUtf16(size_t length, Output (*decode)(const uint8_t *, size_t, bool))
+        {
+            constexpr bool swap = !Endian::IsNative;
+            if constexpr (Source::IsContiguous)
+            {
+                if (source_.Remaining() / 2 < length)
+                {
+                    // Same as ReadToMemory. Zeroes are read past the end of the data
+                    std::string raw(length * 2, '\0');
+                    ReadToMemory(raw.data(), raw.size());
+                    return Checking::Enabled ? Output{} : decode(reinterpret_cast<const uint8_t *>(raw.data()), length, swap);
+                }
+
+                Output output = decode(source_.Current(), length, swap);
+                source_.Advance(length * 2);
+                return output;
+            }
+            else
+            {
+                std::string raw(length * 2, '\0');
+                if (ReadToMemory(raw.data(), raw.size()) != raw.size() && Checking::Enabled)
+                    return Output{};
+
+                return decode(reinterpret_cast<const uint8_t *>(raw.data()), length, swap);
+            }
+        }
+
+        template <typename T>
+        static T ConvertEndian(T value)
+        {
+            if constexpr ((std::is_arithmetic<T>() || std::is_enum<T>()) && sizeof(T) > 1)
+                return Endian::Convert(value);
+            else
+                return value;
+        }
+
+        // Record a failed read. Contiguous sources are moved to the end so the next reads fail without an extra branch
+        void Fail()
+        {
+            if constexpr (Checking::Enabled)
+            {
+                error_ = true;
+                if constexpr (Source::IsContiguous)
+                    source_.Seek(source_.Length());
+            }
+        }
+
+        Source source_;
+        bool error_ = false;
+    };
+}
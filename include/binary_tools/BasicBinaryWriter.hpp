@@ -0,0 +1,333 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+#include <binary_tools/AttributeFormats.hpp>
+#include <binary_tools/Endian.hpp>
+#include <binary_tools/Utf16.hpp>
+
+namespace binary_tools
+{
+    // Binary writer with the data sink and byte order chosen at compile time. Nothing is virtual.
+    // See WriterSinks.hpp for the sink interface. BinaryWriter is an alias of this.
+    template <class Sink, class Endian = NativeEndian>
+    class BasicBinaryWriter
+    {
+    public:
+        // Constructor arguments are forwarded to the sink. E.g. a path and truncate flag for StreamSink.
+        // Explicit so a path or buffer never silently converts into a writer
+        template <typename... Args, typename = std::enable_if_t<std::is_constructible<Sink, Args &&...>::value>>
+        explicit BasicBinaryWriter(Args &&...args)
+            : sink_(std::forward<Args>(args)...)
+        {
+        }
+
+        BasicBinaryWriter(const BasicBinaryWriter &) = delete;
+        BasicBinaryWriter &operator=(const BasicBinaryWriter &) = delete;
+
+        Sink &GetSink()
+        {
+            return sink_;
+        }
+
+        const Sink &GetSink() const
+        {
+            return sink_;
+        }
+
+        // Point the writer at a new destination, reusing the sink's resources. Arguments are forwarded to the sink's Reset()
+        template <typename... Args>
+        void Reset(Args &&...args)
+        {
+            sink_.Reset(std::forward<Args>(args)...);
+        }
+
+        void Flush()
+        {
+            sink_.Flush();
+        }
+
+#pragma region Unsigned integers
+        void WriteUint8(uint8_t value)
+        {
+            Write(value);
+        }
+
+        void WriteUint16(uint16_t value)
+        {
+            Write(value);
+        }
+
+        void WriteUint32(uint32_t value)
+        {
+            Write(value);
+        }
+
+        void WriteUint64(uint64_t value)
+        {
+            Write(value);
+        }
+#pragma endregion
+
+#pragma region Signed integers
+        void WriteInt8(int8_t value)
+        {
+            Write(value);
+        }
+
+        void WriteInt16(int16_t value)
+        {
+            Write(value);
+        }
+
+        void WriteInt32(int32_t value)
+        {
+            Write(value);
+        }
+
+        void WriteInt64(int64_t value)
+        {
+            Write(value);
+        }
+#pragma endregion
+
+        void WriteBoolean(bool value)
+        {
+            WriteUint8(value ? 1 : 0);
+        }
+
+#pragma region Bytes
+        void WriteByte(uint8_t value)
+        {
+            WriteUint8(value);
+        }
+
+        void WriteBytes(const uint8_t *data, size_t size)
+        {
+            sink_.Write(data, size);
+        }
+#pragma endregion
+
+#pragma region Characters
+        void WriteChar(char value)
+        {
+            sink_.Write(&value, 1);
+        }
+
+        // Write string to output with null terminator
+        void WriteNullTerminatedString(const std::string &value)
+        {
+            sink_.Write(value.data(), value.size() + 1); // std::string is always null terminated
+        }
+
+        // Write string to output without null terminator
+        void WriteFixedLengthString(const std::string &value)
+        {
+            sink_.Write(value.data(), value.size());
+        }
+#pragma endregion
+
+#pragma region UTF-16
+        // UTF-16 strings are written in the writer's byte order. E.g. a BigEndian writer writes UTF-16BE.
+        void WriteChar16(char16_t value)
+        {
+            WriteUint16(static_cast<uint16_t>(value));
+        }
+
+        // Write UTF-16 string to output with null terminator
+        void WriteNullTerminatedUtf16String(std::u16string_view value)
+        {
+            WriteFixedLengthUtf16String(value);
+            WriteUint16(0);
+        }
+
+        // Write UTF-16 string to output without null terminator
+        void WriteFixedLengthUtf16String(std::u16string_view value)
+        {
+            if constexpr (Endian::IsNative)
+            {
+                sink_.Write(value.data(), value.size() * 2);
+            }
+            else
+            {
+                // Swap a chunk at a time on the stack
+                uint16_t chunk[128];
+                size_t i = 0;
+                while (i < value.size())
+                {
+                    const size_t count = std::min(value.size() - i, std::size(chunk));
+                    for (size_t j = 0; j < count; j++)
+                        chunk[j] = ByteSwap16(static_cast<uint16_t>(value[i + j]));
+
+                    sink_.Write(chunk, count * 2);
+                    i += count;
+                }
+            }
+        }
+
+        // Transcode a UTF-8 string and write it as UTF-16 with null terminator
+        void WriteNullTerminatedUtf16String(std::string_view utf8)
+        {
+            WriteNullTerminatedUtf16String(std::u16string_view(Utf8ToU16String(utf8)));
+        }
+
+        // Transcode a UTF-8 string and write it as UTF-16 without null terminator
+        void WriteFixedLengthUtf16String(std::string_view utf8)
+        {
+            WriteFixedLengthUtf16String(std::u16string_view(Utf8ToU16String(utf8)));
+        }
+#pragma endregion
+
+#pragma region Floating point
+        void WriteFloat(float value)
+        {
+            Write(value);
+        }
+
+        void WriteDouble(double value)
+        {
+            Write(value);
+        }
+
+        // Write a float as half precision. Rounds to nearest even
+        void WriteHalf(float value)
+        {
+            WriteUint16(FloatToHalf(value));
+        }
+#pragma endregion
+
+#pragma region Attributes
+        // Convert count elements of components floats each to format and write them tightly packed. See EncodeAttribute().
+        // sourceStride is the distance in floats between elements of source, e.g. to write one attribute out of an array of vertex structs
+        void WriteAttribute(AttributeFormat format, size_t components, size_t count, const float *source, size_t sourceStride = 0)
+        {
+            const size_t elementSize = AttributeSize(format, components);
+            sourceStride = sourceStride == 0 ? components : sourceStride;
+
+            // Convert a chunk at a time on the stack
+            uint8_t chunk[4096];
+            const size_t chunkElements = sizeof(chunk) / elementSize;
+            size_t done = 0;
+            while (done < count)
+            {
+                const size_t elements = std::min(chunkElements, count - done);
+                EncodeAttribute(source + done * sourceStride, sourceStride, format, components, elements, chunk, elementSize, !Endian::IsNative);
+                sink_.Write(chunk, elements * elementSize);
+                done += elements;
+            }
+        }
+#pragma endregion
+
+#pragma region Memory
+        void WriteFromMemory(const void *data, size_t size)
+        {
+            sink_.Write(data, size);
+        }
+
+        // Write the bytes of data. Integers, floats and enums are converted to the writer's byte order
+        template <typename T>
+        void Write(const T &data)
+        {
+            // Don't allow T to be a pointer to avoid accidentally writing the value of a pointer instead of what it points to.
+            static_assert(!std::is_pointer<T>(), "BinaryWriter::Write<T> requires T to be a non pointer type.");
+            if constexpr ((std::is_arithmetic<T>() || std::is_enum<T>()) && sizeof(T) > 1)
+            {
+                const T converted = Endian::Convert(data);
+                sink_.Write(&converted, sizeof(T));
+            }
+            else
+            {
+                sink_.Write(&data, sizeof(T));
+            }
+        }
+
+        template <typename T>
+        void WriteSpan(T *data, size_t size)
+        {
+            WriteFromMemory(data, size);
+        }
+#pragma endregion
+
+#pragma region Seek
+        void SeekBeg(size_t absoluteOffset)
+        {
+            sink_.Seek(absoluteOffset);
+        }
+
+        void SeekCur(size_t relativeOffset)
+        {
+            sink_.Seek(Position() + relativeOffset);
+        }
+#pragma endregion
+
+        void Skip(size_t bytesToSkip)
+        {
+            size_t position = Position();
+            size_t length = Length();
+
+            // If we're skipped past the end of the stream then skip what's available and write null bytes for the rest
+            if (position + bytesToSkip > length)
+            {
+                size_t bytesAvailable = length > position ? length - position : 0;
+                size_t bytesNeeded = bytesToSkip - bytesAvailable;
+
+                sink_.Seek(position + bytesAvailable);
+                WriteNullBytes(bytesNeeded);
+            }
+            else
+                sink_.Seek(position + bytesToSkip);
+        }
+
+        void WriteNullBytes(size_t bytesToWrite)
+        {
+            static constexpr char zeros[256] = {};
+            while (bytesToWrite > 0)
+            {
+                const size_t count = bytesToWrite < sizeof(zeros) ? bytesToWrite : sizeof(zeros);
+                if (sink_.Write(zeros, count) == 0)
+                    break;
+
+                bytesToWrite -= count;
+            }
+        }
+
+#pragma region Alignment
+        // Static method for calculating alignment pad from pos and alignment. Does not change position since static
+        static size_t CalcAlign(size_t position, size_t alignmentValue = 2048)
+        {
+            const size_t remainder = position % alignmentValue;
+            size_t paddingSize = remainder > 0 ? alignmentValue - remainder : 0;
+            return paddingSize;
+        }
+
+        // Aligns stream to alignment value. Returns padding byte count
+        size_t Align(size_t alignmentValue = 2048)
+        {
+            const size_t paddingSize = CalcAlign(Position(), alignmentValue);
+            Skip(paddingSize);
+            return paddingSize;
+        }
+#pragma endregion
+
+#pragma region Position and Length
+        size_t Position() const
+        {
+            return sink_.Position();
+        }
+
+        size_t Length()
+        {
+            return sink_.Length();
+        }
+#pragma endregion
+
+    protected:
+        Sink sink_;
+    };
+}
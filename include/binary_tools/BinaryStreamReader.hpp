@@ -0,0 +1,235 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <istream>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+
+#include <binary_tools/BasicBinaryReader.hpp>
+
+namespace binary_tools
+{
+    // Source for streams that can't seek such as stdin, pipes or sockets.
+    // Data is staged in a fixed size ring buffer so memory use stays the same regardless of the input size.
+    // Peeking never seeks the stream. Instead it's limited to the capacity of the ring buffer.
+    class RingBufferSource
+    {
+    public:
+        static constexpr bool IsContiguous = false;
+        static constexpr bool IsSeekable = false;
+        static constexpr size_t DefaultCapacity = 64 * 1024;
+        static constexpr size_t MinimumCapacity = 256; // Large enough for the chunked string search in BasicBinaryReader
+
+        // Reads binary data from stream. The capacity is rounded up to a power of two.
+        // lengthHint is the total size of the input if it's known up front (e.g. from a header or content length).
+        RingBufferSource(std::istream &stream, size_t capacity = DefaultCapacity, std::optional<size_t> lengthHint = std::nullopt)
+            : stream_(&stream), lengthHint_(lengthHint)
+        {
+            size_t roundedCapacity = MinimumCapacity;
+            while (roundedCapacity < capacity)
+                roundedCapacity *= 2;
+
+            capacity_ = roundedCapacity;
+            mask_ = roundedCapacity - 1;
+            buffer_ = std::make_unique<char[]>(roundedCapacity);
+        }
+
+        RingBufferSource(const RingBufferSource &) = delete;
+        RingBufferSource &operator=(const RingBufferSource &) = delete;
+
+        size_t Read(void *destination, size_t size)
+        {
+            char *output = static_cast<char *>(destination);
+
+            // Drain buffered data first
+            const size_t buffered = std::min(tail_ - head_, size);
+            CopyOut(output, buffered);
+            head_ += buffered;
+            size_t bytesRead = buffered;
+
+            if (bytesRead < size)
+            {
+                if (size - bytesRead >= capacity_)
+                {
+                    // Large reads go straight into the destination instead of through the ring buffer
+                    if (!eof_)
+                    {
+                        stream_->read(output + bytesRead, size - bytesRead);
+                        const size_t got = static_cast<size_t>(stream_->gcount());
+                        if (got < size - bytesRead)
+                            eof_ = true;
+
+                        bytesRead += got;
+                        head_ += got;
+                        tail_ += got;
+                    }
+                }
+                else
+                {
+                    const size_t available = std::min(Fill(size - bytesRead), size - bytesRead);
+                    CopyOut(output + bytesRead, available);
+                    head_ += available;
+                    bytesRead += available;
+                }
+            }
+
+            return bytesRead;
+        }
+
+        // Copy the next size bytes without consuming them. size can't be larger than Capacity()
+        size_t Peek(void *destination, size_t size)
+        {
+            if (size > capacity_)
+                throw std::length_error("RingBufferSource::Peek: Lookahead is larger than the ring buffer capacity");
+
+            const size_t available = std::min(Fill(size), size);
+            CopyOut(static_cast<char *>(destination), available);
+            return available;
+        }
+
+        // Copy up to size bytes that already arrived without consuming them. Only blocks while nothing is buffered,
+        // and then just until the first byte arrives. Returns 0 at the end of the stream
+        size_t PeekSome(void *destination, size_t size)
+        {
+            const size_t available = std::min(Fill(1), std::min(size, capacity_));
+            CopyOut(static_cast<char *>(destination), available);
+            return available;
+        }
+
+        size_t Skip(size_t size)
+        {
+            const size_t buffered = std::min(tail_ - head_, size);
+            head_ += buffered;
+            size_t skipped = buffered;
+
+            if (skipped < size && !eof_)
+            {
+                stream_->ignore(static_cast<std::streamsize>(size - skipped));
+                const size_t got = static_cast<size_t>(stream_->gcount());
+                if (got < size - skipped)
+                    eof_ = true;
+
+                skipped += got;
+                head_ += got;
+                tail_ += got;
+            }
+
+            return skipped;
+        }
+
+        // Forward only. Seeking backwards fails
+        bool Seek(size_t absoluteOffset)
+        {
+            if (absoluteOffset < head_)
+                return false;
+
+            const size_t distance = absoluteOffset - head_;
+            return Skip(distance) == distance;
+        }
+
+        bool CanRead(size_t size)
+        {
+            if (lengthHint_)
+                return head_ <= *lengthHint_ && size <= *lengthHint_ - head_;
+            if (size > capacity_)
+                throw std::length_error("RingBufferSource::CanRead: Can't check more than the ring buffer capacity without a length hint");
+
+            return Fill(size) >= size;
+        }
+
+        // Returns true once every byte of the input has been consumed. May block until more data arrives
+        bool EndOfStream()
+        {
+            if (lengthHint_ && head_ >= *lengthHint_)
+                return true;
+
+            return Fill(1) == 0;
+        }
+
+        // Number of bytes consumed so far
+        size_t Position() const
+        {
+            return head_;
+        }
+
+        bool HasLength() const
+        {
+            return lengthHint_.has_value();
+        }
+
+        // Total length of the input. Only available if a length hint was provided since the stream can't be measured
+        size_t Length() const
+        {
+            if (!lengthHint_)
+                throw std::logic_error("RingBufferSource::Length: No length hint was provided");
+
+            return *lengthHint_;
+        }
+
+        size_t Capacity() const
+        {
+            return capacity_;
+        }
+
+    private:
+        // Make sure at least `required` bytes are buffered, blocking until they arrive or the stream ends.
+        // Returns the number of bytes buffered.
+        size_t Fill(size_t required)
+        {
+            while (tail_ - head_ < required && !eof_)
+            {
+                const size_t offset = tail_ & mask_;
+                const size_t contiguousFree = std::min(capacity_ - (tail_ - head_), capacity_ - offset);
+                const size_t needed = std::min(required - (tail_ - head_), contiguousFree);
+                char *destination = buffer_.get() + offset;
+
+                // Only block for the bytes we need so parsing can continue while the rest of the data is in flight
+                stream_->read(destination, static_cast<std::streamsize>(needed));
+                const size_t got = static_cast<size_t>(stream_->gcount());
+                tail_ += got;
+                if (got < needed)
+                {
+                    eof_ = true;
+                    break;
+                }
+
+                // Top up with anything the stream already has available without blocking
+                if (contiguousFree > needed)
+                {
+                    const std::streamsize extra = stream_->readsome(destination + needed, static_cast<std::streamsize>(contiguousFree - needed));
+                    if (extra > 0)
+                        tail_ += static_cast<size_t>(extra);
+                }
+            }
+
+            return tail_ - head_;
+        }
+
+        // Copy size buffered bytes starting at the read head. Handles wrapping around the end of the ring
+        void CopyOut(char *destination, size_t size) const
+        {
+            const size_t offset = head_ & mask_;
+            const size_t firstPart = std::min(size, capacity_ - offset);
+            if (firstPart > 0)
+                std::memcpy(destination, buffer_.get() + offset, firstPart);
+            if (size > firstPart)
+                std::memcpy(destination + firstPart, buffer_.get(), size - firstPart);
+        }
+
+        std::istream *stream_ = nullptr;
+        std::unique_ptr<char[]> buffer_;
+        size_t capacity_ = 0;
+        size_t mask_ = 0;
+        size_t head_ = 0; // Absolute offset of the next byte to read
+        size_t tail_ = 0; // Absolute offset one past the last buffered byte
+        bool eof_ = false;
+        std::optional<size_t> lengthHint_;
+    };
+
+    // Forward-only reader for stdin, pipes and sockets. Constructed with (stream, capacity, lengthHint). See RingBufferSource.
+    // Seeking backwards isn't supported. Forward seeks, Skip() and Align() discard data instead.
+    using BinaryStreamReader = BasicBinaryReader<RingBufferSource, NativeEndian, Unchecked>;
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace binary_tools
+{
+    // Free list of byte buffers that keep their capacity between uses. Use ThreadLocal() to get the calling thread's pool,
+    // so no locking is needed. Buffers larger than MaxPooledCapacity are freed instead of kept.
+    class BufferPool
+    {
+    public:
+        static constexpr size_t MaxPooledBuffers = 16;
+        static constexpr size_t MaxPooledCapacity = 16 * 1024 * 1024;
+
+        static BufferPool &ThreadLocal()
+        {
+            thread_local BufferPool pool;
+            return pool;
+        }
+
+        // Returns an empty buffer, preferably one that can already hold minCapacity bytes
+        std::vector<uint8_t> Acquire(size_t minCapacity = 0)
+        {
+            if (buffers_.empty())
+            {
+                std::vector<uint8_t> buffer;
+                buffer.reserve(minCapacity);
+                return buffer;
+            }
+
+            // Smallest buffer that's big enough, otherwise the largest one so it only grows once
+            size_t best = 0;
+            for (size_t i = 1; i < buffers_.size(); i++)
+            {
+                const size_t capacity = buffers_[i].capacity();
+                const size_t bestCapacity = buffers_[best].capacity();
+                if (bestCapacity >= minCapacity ? (capacity >= minCapacity && capacity < bestCapacity) : capacity > bestCapacity)
+                    best = i;
+            }
+
+            std::vector<uint8_t> buffer = std::move(buffers_[best]);
+            buffers_[best] = std::move(buffers_.back());
+            buffers_.pop_back();
+            buffer.reserve(minCapacity);
+            return buffer;
+        }
+
+        // Return a buffer to the pool for reuse
+        void Release(std::vector<uint8_t> &&buffer)
+        {
+            if (buffer.capacity() == 0 || buffer.capacity() > MaxPooledCapacity || buffers_.size() >= MaxPooledBuffers)
+                return;
+
+            buffer.clear();
+            buffers_.push_back(std::move(buffer));
+        }
+
+        size_t Size() const
+        {
+            return buffers_.size();
+        }
+
+    private:
+        std::vector<std::vector<uint8_t>> buffers_;
+    };
+}
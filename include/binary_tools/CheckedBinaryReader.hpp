@@ -0,0 +1,13 @@
+#pragma once
+
+#include <binary_tools/BasicBinaryReader.hpp>
+#include <binary_tools/ReaderSources.hpp>
+
+namespace binary_tools
+{
+    // Bounds checked reader for untrusted memory buffers. Never throws. Instead a read past the end of the buffer
+    // returns zero and sets a sticky error flag. Once set every following read fails too, so a parser can read a
+    // whole structure and check HasError() once at the end.
+    // Ensure(n) checks a whole block up front. After it succeeds the next n bytes can be read with ReadUnchecked<T>().
+    using CheckedBinaryReader = BasicBinaryReader<MemorySource, NativeEndian, Checked>;
+}
@@ -0,0 +1,305 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <binary_tools/BasicBinaryWriter.hpp>
+#include <binary_tools/MappedFile.hpp>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#undef min
+#undef max
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+#endif
+
+namespace binary_tools
+{
+    // Updates an existing file in place and only writes the regions that actually changed.
+    // Outgoing data is compared against a read only mapping of the original file. Matching data is dropped without
+    // touching the disk. Changed bytes are staged in a block buffer and written with one positional write per dirty
+    // range when the writer moves to another block or is flushed. Rewriting a whole archive after a small edit
+    // costs I/O in proportion to the edit rather than the file size. BytesWritten() reports what actually hit the disk.
+    // The file isn't shrunk unless Truncate() is called.
+    // The destructor flushes too but can't report errors. Call Flush() before destruction to see write failures.
+    class DeltaFileSink
+    {
+    public:
+        static constexpr size_t DefaultBlockSize = 64 * 1024;
+
+        // Opens the file at path for updating. It's created if it doesn't exist. Throws std::runtime_error on failure
+        explicit DeltaFileSink(std::string_view path, size_t blockSize = DefaultBlockSize)
+            : path_(path), blockSize_(std::max<size_t>(blockSize, 512)), block_(blockSize_)
+        {
+#if defined(_WIN32)
+            file_ = CreateFileA(path_.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+            if (file_ == INVALID_HANDLE_VALUE)
+                throw std::runtime_error("DeltaFileSink: Failed to open " + path_);
+#else
+            file_ = ::open(path_.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+            if (file_ < 0)
+                throw std::runtime_error("DeltaFileSink: Failed to open " + path_);
+#endif
+            try
+            {
+                original_.Open(path_);
+            }
+            catch (...)
+            {
+                // The destructor doesn't run for a constructor that throws
+#if defined(_WIN32)
+                CloseHandle(file_);
+#else
+                ::close(file_);
+#endif
+                throw;
+            }
+            length_ = original_.Size();
+        }
+
+        DeltaFileSink(const DeltaFileSink &) = delete;
+        DeltaFileSink &operator=(const DeltaFileSink &) = delete;
+
+        ~DeltaFileSink()
+        {
+            try
+            {
+                Flush();
+            }
+            catch (const std::exception &)
+            {
+            }
+            original_.Close();
+#if defined(_WIN32)
+            CloseHandle(file_);
+#else
+            ::close(file_);
+#endif
+        }
+
+        size_t Write(const void *data, size_t size)
+        {
+            const uint8_t *input = static_cast<const uint8_t *>(data);
+            size_t remaining = size;
+            while (remaining > 0)
+            {
+                const size_t blockIndex = position_ / blockSize_;
+                const size_t blockOffset = position_ % blockSize_;
+                const size_t count = std::min(remaining, blockSize_ - blockOffset);
+                if (blockIndex != blockIndex_)
+                {
+                    FlushBlock();
+                    blockIndex_ = blockIndex;
+                }
+
+                if (!blockLoaded_ && position_ + count <= original_.Size())
+                {
+                    // Unchanged data is compared straight against the mapping without copying
+                    if (std::memcmp(original_.Data() + position_, input, count) != 0)
+                    {
+                        LoadBlock();
+                        StageWrite(blockOffset, input, count);
+                    }
+                }
+                else
+                {
+                    if (!blockLoaded_)
+                        LoadBlock();
+                    if (std::memcmp(block_.data() + blockOffset, input, count) != 0 || position_ + count > length_)
+                        StageWrite(blockOffset, input, count);
+                }
+
+                input += count;
+                remaining -= count;
+                position_ += count;
+            }
+            return size;
+        }
+
+        bool Seek(size_t absoluteOffset)
+        {
+            position_ = absoluteOffset;
+            return true;
+        }
+
+        size_t Position() const
+        {
+            return position_;
+        }
+
+        size_t Length() const
+        {
+            return std::max(length_, dirtyEnd_ > dirtyBegin_ ? blockIndex_ * blockSize_ + dirtyEnd_ : 0);
+        }
+
+        // Write the dirty range of the current block. Throws std::runtime_error on failure and keeps the range dirty
+        void Flush()
+        {
+            FlushBlock();
+        }
+
+        // Cut the file to length. Use after rewriting a file that got shorter
+        void Truncate(size_t length)
+        {
+            FlushBlock();
+            original_.Close(); // Windows can't change the size of a mapped file
+#if defined(_WIN32)
+            LARGE_INTEGER size;
+            size.QuadPart = static_cast<LONGLONG>(length);
+            if (!SetFilePointerEx(file_, size, nullptr, FILE_BEGIN) || !SetEndOfFile(file_))
+                throw std::runtime_error("DeltaFileSink: Failed to truncate " + path_);
+#else
+            if (::ftruncate(file_, static_cast<off_t>(length)) != 0)
+                throw std::runtime_error("DeltaFileSink: Failed to truncate " + path_);
+#endif
+            length_ = length;
+            original_.Open(path_);
+        }
+
+        // Bytes actually written to the file so far
+        uint64_t BytesWritten() const
+        {
+            return bytesWritten_;
+        }
+
+        size_t BlockSize() const
+        {
+            return blockSize_;
+        }
+
+    private:
+        static constexpr size_t NoBlock = static_cast<size_t>(-1);
+
+        // Copy the current contents of the block into the block buffer. Anything past the end of the file reads as zero
+        void LoadBlock()
+        {
+            const size_t blockStart = blockIndex_ * blockSize_;
+            const size_t fileSize = original_.Size();
+            std::fill(block_.begin(), block_.end(), uint8_t(0));
+
+            // The mapping is shared, so it already shows blocks written earlier in this session
+            size_t loaded = 0;
+            if (blockStart < fileSize)
+            {
+                loaded = std::min(blockSize_, fileSize - blockStart);
+                std::memcpy(block_.data(), original_.Data() + blockStart, loaded);
+            }
+            if (blockStart + loaded < length_)
+                PositionalRead(block_.data() + loaded, std::min(blockSize_, length_ - blockStart) - loaded, blockStart + loaded);
+
+            blockLoaded_ = true;
+        }
+
+        void StageWrite(size_t blockOffset, const uint8_t *data, size_t size)
+        {
+            std::memcpy(block_.data() + blockOffset, data, size);
+            if (dirtyEnd_ <= dirtyBegin_)
+            {
+                dirtyBegin_ = blockOffset;
+                dirtyEnd_ = blockOffset + size;
+            }
+            else
+            {
+                dirtyBegin_ = std::min(dirtyBegin_, blockOffset);
+                dirtyEnd_ = std::max(dirtyEnd_, blockOffset + size);
+            }
+        }
+
+        void FlushBlock()
+        {
+            if (blockIndex_ != NoBlock && dirtyEnd_ > dirtyBegin_)
+            {
+                const size_t blockStart = blockIndex_ * blockSize_;
+                PositionalWrite(block_.data() + dirtyBegin_, dirtyEnd_ - dirtyBegin_, blockStart + dirtyBegin_);
+                bytesWritten_ += dirtyEnd_ - dirtyBegin_;
+                length_ = std::max(length_, blockStart + dirtyEnd_);
+            }
+            dirtyBegin_ = 0;
+            dirtyEnd_ = 0;
+            blockLoaded_ = false;
+            blockIndex_ = NoBlock;
+        }
+
+        void PositionalWrite(const uint8_t *data, size_t size, size_t offset)
+        {
+            while (size > 0)
+            {
+#if defined(_WIN32)
+                OVERLAPPED overlapped = {};
+                overlapped.Offset = static_cast<DWORD>(offset);
+                overlapped.OffsetHigh = static_cast<DWORD>(static_cast<uint64_t>(offset) >> 32);
+                DWORD written = 0;
+                if (!WriteFile(file_, data, static_cast<DWORD>(std::min<size_t>(size, 1u << 30)), &written, &overlapped) || written == 0)
+                    throw std::runtime_error("DeltaFileSink: Failed to write " + path_);
+#else
+                const ssize_t written = ::pwrite(file_, data, size, static_cast<off_t>(offset));
+                if (written < 0 && errno == EINTR)
+                    continue;
+                if (written <= 0)
+                    throw std::runtime_error("DeltaFileSink: Failed to write " + path_);
+#endif
+                data += written;
+                size -= static_cast<size_t>(written);
+                offset += static_cast<size_t>(written);
+            }
+        }
+
+        void PositionalRead(uint8_t *data, size_t size, size_t offset)
+        {
+            while (size > 0)
+            {
+#if defined(_WIN32)
+                OVERLAPPED overlapped = {};
+                overlapped.Offset = static_cast<DWORD>(offset);
+                overlapped.OffsetHigh = static_cast<DWORD>(static_cast<uint64_t>(offset) >> 32);
+                DWORD count = 0;
+                if (!ReadFile(file_, data, static_cast<DWORD>(std::min<size_t>(size, 1u << 30)), &count, &overlapped))
+                    throw std::runtime_error("DeltaFileSink: Failed to read " + path_);
+#else
+                const ssize_t count = ::pread(file_, data, size, static_cast<off_t>(offset));
+                if (count < 0)
+                    throw std::runtime_error("DeltaFileSink: Failed to read " + path_);
+#endif
+                if (count == 0)
+                    break; // Past the end of the file. The block buffer is already zeroed
+
+                data += count;
+                size -= static_cast<size_t>(count);
+                offset += static_cast<size_t>(count);
+            }
+        }
+
+        std::string path_;
+#if defined(_WIN32)
+        HANDLE file_ = INVALID_HANDLE_VALUE;
+#else
+        int file_ = -1;
+#endif
+        MappedFile original_;
+        size_t blockSize_ = DefaultBlockSize;
+        std::vector<uint8_t> block_;
+        size_t blockIndex_ = NoBlock;
+        bool blockLoaded_ = false;
+        size_t dirtyBegin_ = 0; // Dirty range of the block buffer
+        size_t dirtyEnd_ = 0;
+        size_t position_ = 0;
+        size_t length_ = 0; // File length including flushed writes
+        uint64_t bytesWritten_ = 0;
+    };
+
+    // Writer that only writes the blocks that differ from the existing file. Constructed with (path, blockSize). See DeltaFileSink
+    using DeltaBinaryWriter = BasicBinaryWriter<DeltaFileSink, NativeEndian>;
+}
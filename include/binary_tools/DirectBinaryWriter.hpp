@@ -0,0 +1,525 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <thread>
+
+#include <binary_tools/BasicBinaryWriter.hpp>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <malloc.h>
+#include <windows.h>
+#undef min
+#undef max
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+#endif
+
+namespace binary_tools
+{
+    // Writes large files with direct I/O (O_DIRECT, F_NOCACHE on macOS, FILE_FLAG_NO_BUFFERING on Windows), bypassing the page cache
+    // so a multi GB output doesn't evict other processes' data or cause writeback stalls.
+    // Data is staged in two aligned buffers. A background thread writes one while the other is filled. The unaligned tail is padded
+    // to the alignment when it's written and the file is truncated to its real length by Flush() and Close().
+    // Writes before the buffered region (e.g. patching a header) are done synchronously as aligned read-modify-writes.
+    // If the file system rejects direct I/O the sink falls back to buffered writes. dropCache then keeps the page cache clean
+    // by starting writeback of each buffer with sync_file_range() and dropping the previous one with posix_fadvise(DONTNEED).
+    class DirectFileSink
+    {
+    public:
+        static constexpr size_t Alignment = 4096; // Covers 512 byte and 4K sector devices
+        static constexpr size_t DefaultBufferSize = 8 * 1024 * 1024;
+
+        // Creates or truncates the file at path. bufferSize is rounded up to a multiple of Alignment. Throws std::runtime_error on failure
+        explicit DirectFileSink(std::string_view path, size_t bufferSize = DefaultBufferSize, bool dropCache = false)
+            : path_(path), dropCache_(dropCache)
+        {
+            bufferSize_ = std::max(Alignment, (bufferSize + Alignment - 1) / Alignment * Alignment);
+            OpenFile();
+
+            active_ = AllocateAligned(bufferSize_);
+            spare_ = AllocateAligned(bufferSize_);
+            if (!active_ || !spare_)
+            {
+                Release();
+                throw std::bad_alloc();
+            }
+
+            writer_ = std::thread([this]() { WriterLoop(); });
+        }
+
+        DirectFileSink(const DirectFileSink &) = delete;
+        DirectFileSink &operator=(const DirectFileSink &) = delete;
+
+        ~DirectFileSink()
+        {
+            try
+            {
+                Close();
+            }
+            catch (const std::exception &)
+            {
+            }
+            Release();
+        }
+
+        size_t Write(const void *data, size_t size)
+        {
+            const uint8_t *input = static_cast<const uint8_t *>(data);
+            size_t remaining = size;
+
+            // Anything before the active buffer is already on disk
+            if (position_ < bufferStart_ && remaining > 0)
+            {
+                const size_t count = std::min(remaining, bufferStart_ - position_);
+                Patch(input, count, position_);
+                input += count;
+                remaining -= count;
+                position_ += count;
+            }
+
+            while (remaining > 0)
+            {
+                const size_t offset = position_ - bufferStart_;
+                if (offset >= bufferSize_)
+                {
+                    SkipTo(position_);
+                    continue;
+                }
+                if (offset > used_)
+                    std::memset(active_ + used_, 0, offset - used_);
+
+                const size_t count = std::min(remaining, bufferSize_ - offset);
+                std::memcpy(active_ + offset, input, count);
+                input += count;
+                remaining -= count;
+                position_ += count;
+                used_ = std::max(used_, offset + count);
+
+                if (used_ == bufferSize_)
+                    SubmitActive();
+            }
+            return size;
+        }
+
+        // Seeking forward past the end leaves a gap of zeros once more data is written. Gaps past the buffer aren't written,
+        // so they stay sparse on file systems that support it
+        bool Seek(size_t absoluteOffset)
+        {
+            position_ = absoluteOffset;
+            return true;
+        }
+
+        size_t Position() const
+        {
+            return position_;
+        }
+
+        size_t Length() const
+        {
+            return bufferStart_ + used_;
+        }
+
+        // Write everything buffered so far and set the file to its real length. The tail stays buffered so writing can continue.
+        // Throws std::runtime_error on failure
+        void Flush()
+        {
+            if (closed_)
+                return;
+
+            WaitIdle();
+            if (used_ > 0)
+            {
+                const size_t padded = (used_ + Alignment - 1) / Alignment * Alignment;
+                std::memset(active_ + used_, 0, padded - used_);
+                WriteAt(active_, padded, bufferStart_);
+            }
+            Truncate(Length());
+        }
+
+        // Flush, stop the background writer and close the file. Throws std::runtime_error on failure
+        void Close()
+        {
+            if (closed_)
+                return;
+
+            std::exception_ptr error;
+            try
+            {
+                Flush();
+            }
+            catch (...)
+            {
+                error = std::current_exception();
+            }
+            StopWriter();
+            CloseFile();
+            closed_ = true;
+            if (error)
+                std::rethrow_exception(error);
+        }
+
+        // False if the file system rejected direct I/O and writes go through the page cache
+        bool IsDirect() const
+        {
+            return direct_;
+        }
+
+        size_t BufferSize() const
+        {
+            return bufferSize_;
+        }
+
+    private:
+        static uint8_t *AllocateAligned(size_t size)
+        {
+#if defined(_WIN32)
+            return static_cast<uint8_t *>(_aligned_malloc(size, Alignment));
+#else
+            void *memory = nullptr;
+            return posix_memalign(&memory, Alignment, size) == 0 ? static_cast<uint8_t *>(memory) : nullptr;
+#endif
+        }
+
+        static void FreeAligned(uint8_t *memory)
+        {
+#if defined(_WIN32)
+            _aligned_free(memory);
+#else
+            std::free(memory);
+#endif
+        }
+
+        void Release()
+        {
+            StopWriter();
+            CloseFile();
+            FreeAligned(active_);
+            FreeAligned(spare_);
+            FreeAligned(scratch_);
+            active_ = spare_ = scratch_ = nullptr;
+        }
+
+        // Hand the full active buffer to the writer thread and continue in the spare one
+        void SubmitActive()
+        {
+            WaitIdle();
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                pendingBuffer_ = active_;
+                pendingOffset_ = bufferStart_;
+                pendingSize_ = used_;
+                busy_ = true;
+            }
+            condition_.notify_all();
+
+            std::swap(active_, spare_);
+            bufferStart_ += used_;
+            used_ = 0;
+        }
+
+        // Write the buffered data and continue in the aligned block containing offset, which is past the end of the buffer.
+        // The file is extended up to that block without writing the gap
+        void SkipTo(size_t offset)
+        {
+            WaitIdle();
+            if (used_ > 0)
+            {
+                const size_t padded = (used_ + Alignment - 1) / Alignment * Alignment;
+                std::memset(active_ + used_, 0, padded - used_);
+                WriteAt(active_, padded, bufferStart_);
+            }
+
+            bufferStart_ = offset / Alignment * Alignment;
+            used_ = 0;
+            Truncate(bufferStart_);
+        }
+
+        // Wait for the writer thread to finish the pending buffer. Rethrows its error
+        void WaitIdle()
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            condition_.wait(lock, [this]() { return !busy_; });
+            if (writeError_ != 0)
+                throw std::system_error(writeError_, std::system_category(), "DirectFileSink: Failed to write " + path_);
+        }
+
+        void WriterLoop()
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            while (true)
+            {
+                condition_.wait(lock, [this]() { return busy_ || stop_; });
+                if (!busy_)
+                    return;
+
+                uint8_t *buffer = pendingBuffer_;
+                const size_t offset = pendingOffset_;
+                const size_t size = pendingSize_;
+                lock.unlock();
+
+                int error = 0;
+                try
+                {
+                    WriteAt(buffer, size, offset);
+                    if (dropCache_)
+                        DropWrittenPages(offset, size);
+                }
+                catch (const std::system_error &e)
+                {
+                    error = e.code().value();
+                }
+
+                lock.lock();
+                if (error != 0 && writeError_ == 0)
+                    writeError_ = error;
+                busy_ = false;
+                condition_.notify_all();
+            }
+        }
+
+        void StopWriter()
+        {
+            if (!writer_.joinable())
+                return;
+
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                stop_ = true;
+            }
+            condition_.notify_all();
+            writer_.join();
+        }
+
+        // Read-modify-write the aligned blocks covering [offset, offset + size). Only used for data that's already on disk
+        void Patch(const uint8_t *data, size_t size, size_t offset)
+        {
+            WaitIdle();
+            if (!scratch_)
+            {
+                scratch_ = AllocateAligned(Alignment);
+                if (!scratch_)
+                    throw std::bad_alloc();
+            }
+
+            while (size > 0)
+            {
+                const size_t blockStart = offset / Alignment * Alignment;
+                const size_t blockOffset = offset - blockStart;
+                const size_t count = std::min(size, Alignment - blockOffset);
+                ReadAt(scratch_, Alignment, blockStart);
+                std::memcpy(scratch_ + blockOffset, data, count);
+                WriteAt(scratch_, Alignment, blockStart);
+
+                data += count;
+                size -= count;
+                offset += count;
+            }
+        }
+
+#if defined(_WIN32)
+        void OpenFile()
+        {
+            file_ = CreateFileA(path_.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_NO_BUFFERING, nullptr);
+            if (file_ == INVALID_HANDLE_VALUE)
+            {
+                direct_ = false;
+                file_ = CreateFileA(path_.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+            }
+            if (file_ == INVALID_HANDLE_VALUE)
+                throw std::runtime_error("DirectFileSink: Failed to open " + path_);
+        }
+
+        void CloseFile()
+        {
+            if (file_ != INVALID_HANDLE_VALUE)
+                CloseHandle(file_);
+            file_ = INVALID_HANDLE_VALUE;
+        }
+
+        void WriteAt(const uint8_t *data, size_t size, size_t offset)
+        {
+            while (size > 0)
+            {
+                OVERLAPPED overlapped = {};
+                overlapped.Offset = static_cast<DWORD>(offset);
+                overlapped.OffsetHigh = static_cast<DWORD>(static_cast<uint64_t>(offset) >> 32);
+                DWORD written = 0;
+                const DWORD count = static_cast<DWORD>(std::min<size_t>(size, 1u << 30));
+                if (!WriteFile(file_, data, count, &written, &overlapped) || written == 0)
+                    throw std::system_error(static_cast<int>(GetLastError()), std::system_category(), "DirectFileSink: Failed to write " + path_);
+
+                data += written;
+                size -= written;
+                offset += written;
+            }
+        }
+
+        void ReadAt(uint8_t *data, size_t size, size_t offset)
+        {
+            OVERLAPPED overlapped = {};
+            overlapped.Offset = static_cast<DWORD>(offset);
+            overlapped.OffsetHigh = static_cast<DWORD>(static_cast<uint64_t>(offset) >> 32);
+            DWORD count = 0;
+            if (!ReadFile(file_, data, static_cast<DWORD>(size), &count, &overlapped) || count != size)
+                throw std::runtime_error("DirectFileSink: Failed to read back " + path_);
+        }
+
+        void Truncate(size_t length)
+        {
+            FILE_END_OF_FILE_INFO info;
+            info.EndOfFile.QuadPart = static_cast<LONGLONG>(length);
+            if (!SetFileInformationByHandle(file_, FileEndOfFileInfo, &info, sizeof(info)))
+                throw std::runtime_error("DirectFileSink: Failed to truncate " + path_);
+        }
+
+        void DropWrittenPages(size_t, size_t)
+        {
+            // Buffered fallback on Windows relies on the cache manager
+        }
+#else
+        void OpenFile()
+        {
+            const int flags = O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC; // Read access is needed for patching
+#if defined(O_DIRECT)
+            file_ = ::open(path_.c_str(), flags | O_DIRECT, 0644);
+            if (file_ < 0 && errno == EINVAL)
+            {
+                direct_ = false; // Not supported by this file system
+                file_ = ::open(path_.c_str(), flags, 0644);
+            }
+#else
+            file_ = ::open(path_.c_str(), flags, 0644);
+#if defined(F_NOCACHE)
+            direct_ = file_ >= 0 && ::fcntl(file_, F_NOCACHE, 1) == 0;
+#else
+            direct_ = false;
+#endif
+#endif
+            if (file_ < 0)
+                throw std::runtime_error("DirectFileSink: Failed to open " + path_);
+        }
+
+        void CloseFile()
+        {
+            if (file_ >= 0)
+                ::close(file_);
+            file_ = -1;
+        }
+
+        void WriteAt(const uint8_t *data, size_t size, size_t offset)
+        {
+            while (size > 0)
+            {
+                const ssize_t written = ::pwrite(file_, data, size, static_cast<off_t>(offset));
+                if (written < 0)
+                {
+                    if (errno == EINTR)
+                        continue;
+#if defined(O_DIRECT)
+                    // Some file systems accept O_DIRECT when opening and reject the write
+                    if (errno == EINVAL && direct_)
+                    {
+                        ::fcntl(file_, F_SETFL, ::fcntl(file_, F_GETFL) & ~O_DIRECT);
+                        direct_ = false;
+                        continue;
+                    }
+#endif
+                    throw std::system_error(errno, std::generic_category(), "DirectFileSink: Failed to write " + path_);
+                }
+
+                data += written;
+                size -= static_cast<size_t>(written);
+                offset += static_cast<size_t>(written);
+            }
+        }
+
+        void ReadAt(uint8_t *data, size_t size, size_t offset)
+        {
+            size_t done = 0;
+            while (done < size)
+            {
+                const ssize_t count = ::pread(file_, data + done, size - done, static_cast<off_t>(offset + done));
+                if (count < 0 && errno == EINTR)
+                    continue;
+                if (count <= 0)
+                    throw std::runtime_error("DirectFileSink: Failed to read back " + path_);
+
+                done += static_cast<size_t>(count);
+            }
+        }
+
+        void Truncate(size_t length)
+        {
+            if (::ftruncate(file_, static_cast<off_t>(length)) != 0)
+                throw std::runtime_error("DirectFileSink: Failed to truncate " + path_);
+        }
+
+        // Start writeback of the buffer just written and drop the one before it from the page cache once it's on disk.
+        // Keeps dirty pages bounded to about two buffers instead of letting the kernel flush in bursts
+        void DropWrittenPages(size_t offset, size_t size)
+        {
+#if defined(__linux__)
+            ::sync_file_range(file_, static_cast<off_t>(offset), static_cast<off_t>(size), SYNC_FILE_RANGE_WRITE);
+            if (offset >= size)
+            {
+                const off_t previous = static_cast<off_t>(offset - size);
+                ::sync_file_range(file_, previous, static_cast<off_t>(size), SYNC_FILE_RANGE_WAIT_BEFORE | SYNC_FILE_RANGE_WRITE | SYNC_FILE_RANGE_WAIT_AFTER);
+                ::posix_fadvise(file_, previous, static_cast<off_t>(size), POSIX_FADV_DONTNEED);
+            }
+#else
+            (void)offset;
+            (void)size;
+#endif
+        }
+#endif
+
+        std::string path_;
+#if defined(_WIN32)
+        HANDLE file_ = INVALID_HANDLE_VALUE;
+#else
+        int file_ = -1;
+#endif
+        std::atomic<bool> direct_ = true; // Cleared by the writer thread if a direct write is rejected
+        bool dropCache_ = false;
+        bool closed_ = false;
+        size_t bufferSize_ = DefaultBufferSize;
+        uint8_t *active_ = nullptr; // Being filled by Write()
+        uint8_t *spare_ = nullptr;  // Being written by the writer thread, or free
+        uint8_t *scratch_ = nullptr; // One aligned block for Patch()
+        size_t bufferStart_ = 0;     // File offset of active_[0]. Everything before it has been submitted
+        size_t used_ = 0;            // Bytes of active_ holding data
+        size_t position_ = 0;
+
+        // Shared with the writer thread
+        std::thread writer_;
+        std::mutex mutex_;
+        std::condition_variable condition_;
+        uint8_t *pendingBuffer_ = nullptr;
+        size_t pendingOffset_ = 0;
+        size_t pendingSize_ = 0;
+        bool busy_ = false;
+        bool stop_ = false;
+        int writeError_ = 0;
+    };
+
+    // Writer for very large outputs that bypasses the page cache. Constructed with (path, bufferSize, dropCache). See DirectFileSink
+    using DirectBinaryWriter = BasicBinaryWriter<DirectFileSink, NativeEndian>;
+}
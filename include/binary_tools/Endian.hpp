@@ -0,0 +1,112 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#if defined(_MSC_VER)
+#include <stdlib.h>
+#endif
+
+namespace binary_tools
+{
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    constexpr bool IsHostLittleEndian = false;
+#else
+    constexpr bool IsHostLittleEndian = true; // Windows and every other platform we build for are little endian
+#endif
+
+    inline uint16_t ByteSwap16(uint16_t value)
+    {
+#if defined(_MSC_VER)
+        return _byteswap_ushort(value);
+#else
+        return __builtin_bswap16(value);
+#endif
+    }
+
+    inline uint32_t ByteSwap32(uint32_t value)
+    {
+#if defined(_MSC_VER)
+        return _byteswap_ulong(value);
+#else
+        return __builtin_bswap32(value);
+#endif
+    }
+
+    inline uint64_t ByteSwap64(uint64_t value)
+    {
+#if defined(_MSC_VER)
+        return _byteswap_uint64(value);
+#else
+        return __builtin_bswap64(value);
+#endif
+    }
+
+    // Reverse the byte order of a 1, 2, 4 or 8 byte value. Works for integers, floats and enums
+    template <typename T>
+    T ByteSwap(T value)
+    {
+        static_assert(sizeof(T) == 1 || sizeof(T) == 2 || sizeof(T) == 4 || sizeof(T) == 8, "ByteSwap<T> requires a 1, 2, 4 or 8 byte type.");
+        if constexpr (sizeof(T) == 1)
+        {
+            return value;
+        }
+        else if constexpr (sizeof(T) == 2)
+        {
+            uint16_t bits;
+            std::memcpy(&bits, &value, 2);
+            bits = ByteSwap16(bits);
+            std::memcpy(&value, &bits, 2);
+            return value;
+        }
+        else if constexpr (sizeof(T) == 4)
+        {
+            uint32_t bits;
+            std::memcpy(&bits, &value, 4);
+            bits = ByteSwap32(bits);
+            std::memcpy(&value, &bits, 4);
+            return value;
+        }
+        else
+        {
+            uint64_t bits;
+            std::memcpy(&bits, &value, 8);
+            bits = ByteSwap64(bits);
+            std::memcpy(&value, &bits, 8);
+            return value;
+        }
+    }
+
+    // Byte order policies used by BasicBinaryReader and BasicBinaryWriter.
+    // Convert() translates between the host byte order and the byte order of the data in both directions.
+    struct LittleEndian
+    {
+        static constexpr bool IsNative = IsHostLittleEndian;
+
+        template <typename T>
+        static T Convert(T value)
+        {
+            if constexpr (IsNative)
+                return value;
+            else
+                return ByteSwap(value);
+        }
+    };
+
+    struct BigEndian
+    {
+        static constexpr bool IsNative = !IsHostLittleEndian;
+
+        template <typename T>
+        static T Convert(T value)
+        {
+            if constexpr (IsNative)
+                return value;
+            else
+                return ByteSwap(value);
+        }
+    };
+
+    using NativeEndian = std::conditional_t<IsHostLittleEndian, LittleEndian, BigEndian>;
+}
@@ -0,0 +1,162 @@
+#pragma once
+
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#undef min
+#undef max
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace binary_tools
+{
+    // Read only memory mapping of a whole file. The mapping is released when the object is destroyed.
+    class MappedFile
+    {
+    public:
+        MappedFile() = default;
+
+        // Maps the file at path. Throws std::runtime_error if it can't be opened or mapped
+        explicit MappedFile(std::string_view path)
+        {
+            Open(path);
+        }
+
+        MappedFile(const MappedFile &) = delete;
+        MappedFile &operator=(const MappedFile &) = delete;
+
+        MappedFile(MappedFile &&other) noexcept
+        {
+            *this = std::move(other);
+        }
+
+        MappedFile &operator=(MappedFile &&other) noexcept
+        {
+            if (this != &other)
+            {
+                Close();
+                data_ = std::exchange(other.data_, nullptr);
+                size_ = std::exchange(other.size_, 0);
+#if defined(_WIN32)
+                mapping_ = std::exchange(other.mapping_, nullptr);
+#endif
+            }
+            return *this;
+        }
+
+        ~MappedFile()
+        {
+            Close();
+        }
+
+        void Open(std::string_view path)
+        {
+            Close();
+            const std::string pathString(path);
+
+#if defined(_WIN32)
+            HANDLE file = CreateFileA(pathString.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+            if (file == INVALID_HANDLE_VALUE)
+                throw std::runtime_error("Failed to open file for mapping: " + pathString);
+
+            LARGE_INTEGER fileSize;
+            if (!GetFileSizeEx(file, &fileSize))
+            {
+                CloseHandle(file);
+                throw std::runtime_error("Failed to get size of file: " + pathString);
+            }
+
+            size_ = static_cast<size_t>(fileSize.QuadPart);
+            if (size_ > 0)
+            {
+                mapping_ = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+                if (mapping_)
+                    data_ = static_cast<const uint8_t *>(MapViewOfFile(mapping_, FILE_MAP_READ, 0, 0, 0));
+            }
+            CloseHandle(file); // The mapping keeps its own reference to the file
+
+            if (size_ > 0 && !data_)
+            {
+                Close();
+                throw std::runtime_error("Failed to map file: " + pathString);
+            }
+#else
+            const int fd = ::open(pathString.c_str(), O_RDONLY | O_CLOEXEC);
+            if (fd < 0)
+                throw std::runtime_error("Failed to open file for mapping: " + pathString);
+
+            struct stat fileStat;
+            if (::fstat(fd, &fileStat) != 0)
+            {
+                ::close(fd);
+                throw std::runtime_error("Failed to get size of file: " + pathString);
+            }
+
+            size_ = static_cast<size_t>(fileStat.st_size);
+            if (size_ > 0)
+            {
+                void *mapping = ::mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd, 0);
+                if (mapping != MAP_FAILED)
+                    data_ = static_cast<const uint8_t *>(mapping);
+            }
+            ::close(fd); // The mapping keeps its own reference to the file
+
+            if (size_ > 0 && !data_)
+            {
+                size_ = 0;
+                throw std::runtime_error("Failed to map file: " + pathString);
+            }
+#endif
+        }
+
+        void Close()
+        {
+#if defined(_WIN32)
+            if (data_)
+                UnmapViewOfFile(data_);
+            if (mapping_)
+                CloseHandle(mapping_);
+            mapping_ = nullptr;
+#else
+            if (data_)
+                ::munmap(const_cast<uint8_t *>(data_), size_);
+#endif
+            data_ = nullptr;
+            size_ = 0;
+        }
+
+        bool IsOpen() const
+        {
+            return data_ != nullptr;
+        }
+
+        const uint8_t *Data() const
+        {
+            return data_;
+        }
+
+        size_t Size() const
+        {
+            return size_;
+        }
+
+    private:
+        const uint8_t *data_ = nullptr;
+        size_t size_ = 0;
+#if defined(_WIN32)
+        HANDLE mapping_ = nullptr;
+#endif
+    };
+}
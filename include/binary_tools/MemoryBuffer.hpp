@@ -5,8 +5,13 @@
 
 #include <streambuf>
 #include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
 #include <numeric>
 #include <limits>
+#include <stdexcept>
+#include <string>
 
 namespace binary_tools
 {
@@ -17,10 +22,45 @@ namespace binary_tools
         MemoryBuffer(char *begin, char *end)
         {
             this->setg(begin, begin, end);
+            this->setp(begin, end);
         }
         MemoryBuffer(char *begin, uint32_t sizeInBytes)
+        {
+            Reset(begin, sizeInBytes);
+        }
+
+        // Point the buffer at a new memory region
+        void Reset(char *begin, uint32_t sizeInBytes)
         {
             this->setg(begin, begin, begin + sizeInBytes);
+            this->setp(begin, begin + sizeInBytes);
+        }
+
+    protected:
+        // Only the put position can be moved. Needed by BinaryWriter for Position(), Length() and seeking
+        pos_type seekoff(off_type off, std::ios_base::seekdir dir, std::ios_base::openmode which = std::ios_base::out) override
+        {
+            if (!(which & std::ios_base::out))
+                return pos_type(off_type(-1));
+
+            off_type base = 0;
+            if (dir == std::ios_base::cur)
+                base = pptr() - pbase();
+            else if (dir == std::ios_base::end)
+                base = epptr() - pbase();
+
+            const off_type target = base + off;
+            if (target < 0 || target > epptr() - pbase())
+                return pos_type(off_type(-1));
+
+            setp(pbase(), epptr());
+            pbump((int)target);
+            return target;
+        }
+
+        pos_type seekpos(pos_type pos, std::ios_base::openmode which = std::ios_base::out) override
+        {
+            return seekoff(off_type(pos), std::ios_base::beg, which);
         }
     };
 
@@ -112,6 +152,15 @@ namespace binary_tools
 
         basic_memstreambuf &operator=(const basic_memstreambuf &) = delete;
 
+        // non-standard. Point the buffer at a new memory region
+        void reset(const char_type *s, std::streamsize n)
+        {
+            setg(
+                const_cast<char_type *>(s),
+                const_cast<char_type *>(s),
+                const_cast<char_type *>(s + n));
+        }
+
     protected:
         virtual std::streamsize showmanyc() override
         {
@@ -143,16 +192,13 @@ namespace binary_tools
                 count,
                 static_cast<std::streamsize>(egptr() - ptr));
 
-            if (to_read == 0)
-            {
-                return traits_type::eof();
-            }
-            else
+            // Returning eof() here would be treated as a byte count by std::istream::read()
+            if (to_read > 0)
             {
                 std::memcpy(s, ptr, to_read);
                 gbump((int)to_read);
-                return to_read;
             }
+            return to_read;
         }
 
         virtual pos_type seekoff(
@@ -168,7 +214,7 @@ namespace binary_tools
 
             if (dir == std::ios_base::beg)
             {
-                if (off >= 0 && off < egptr() - eback())
+                if (off >= 0 && off <= egptr() - eback())
                 {
                     setg(eback(), eback() + off, egptr());
                 }
@@ -181,7 +227,7 @@ namespace binary_tools
             else if (dir == std::ios_base::cur)
             {
                 if ((off >= 0 && off <= egptr() - gptr()) ||
-                    (off < 0 && std::abs(off) < gptr() - eback()))
+                    (off < 0 && std::abs(off) <= gptr() - eback()))
                 {
                     gbump((int)off);
                 }
@@ -193,7 +239,7 @@ namespace binary_tools
             }
             else if (dir == std::ios_base::end)
             {
-                if (off <= 0 && std::abs(off) < egptr() - eback())
+                if (off <= 0 && std::abs(off) <= egptr() - eback())
                 {
                     setg(eback(), egptr() + (int)off, egptr());
                 }
@@ -222,7 +268,7 @@ namespace binary_tools
                 throw std::invalid_argument("basic_memstreambuf::seekpos[which]");
             }
 
-            if (pos < egptr() - eback())
+            if (pos <= egptr() - eback())
             {
                 setg(eback(), eback() + pos, egptr());
             }
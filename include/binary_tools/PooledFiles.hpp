@@ -0,0 +1,355 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <binary_tools/BinaryReader.hpp>
+#include <binary_tools/BinaryWriter.hpp>
+#include <binary_tools/BufferPool.hpp>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#undef min
+#undef max
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+#endif
+
+namespace binary_tools
+{
+    // Reads small files whole with as few syscalls as possible: openat() relative to an already open directory, fstat()
+    // for the size and a single read() into a reused buffer. Meant for workloads that touch many tiny files, where
+    // per file setup costs more than the parsing.
+    class SmallFileLoader
+    {
+    public:
+        // Paths are relative to the working directory
+        SmallFileLoader() = default;
+
+        // Paths are relative to directory. Throws std::runtime_error if it can't be opened
+        explicit SmallFileLoader(std::string_view directory)
+        {
+#if defined(_WIN32)
+            directory_ = std::string(directory) + "\\";
+#else
+            directory_ = ::open(std::string(directory).c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+            if (directory_ < 0)
+                throw std::runtime_error("SmallFileLoader: Failed to open directory " + std::string(directory));
+#endif
+        }
+
+        SmallFileLoader(const SmallFileLoader &) = delete;
+        SmallFileLoader &operator=(const SmallFileLoader &) = delete;
+
+        ~SmallFileLoader()
+        {
+#if !defined(_WIN32)
+            if (directory_ >= 0)
+                ::close(directory_);
+#endif
+        }
+
+        // Replace the contents of buffer with the file at path. Returns false if it couldn't be read
+        bool Load(std::string_view path, std::vector<uint8_t> &buffer)
+        {
+#if defined(_WIN32)
+            path_.assign(directory_).append(path);
+            return LoadFile(path_.c_str(), buffer);
+#else
+            path_.assign(path); // Reused so paths don't allocate once it's grown
+            return LoadFileAt(directory_, path_.c_str(), buffer);
+#endif
+        }
+
+        // Load each path and call callback(path, reader) with a MemoryBinaryReader over its contents.
+        // One pooled buffer is reused for every file, so the data is only valid during the callback.
+        // Files that can't be read are skipped. Returns the number of files loaded.
+        template <typename Paths, typename Callback>
+        size_t LoadAll(const Paths &paths, Callback &&callback)
+        {
+            BufferPool &pool = BufferPool::ThreadLocal();
+            std::vector<uint8_t> buffer = pool.Acquire();
+            MemoryBinaryReader reader(static_cast<const uint8_t *>(nullptr), 0);
+            size_t loaded = 0;
+            try
+            {
+                for (const auto &path : paths)
+                {
+                    if (!Load(path, buffer))
+                        continue;
+
+                    reader.Reset(buffer.data(), buffer.size());
+                    callback(path, reader);
+                    loaded++;
+                }
+            }
+            catch (...)
+            {
+                pool.Release(std::move(buffer));
+                throw;
+            }
+
+            pool.Release(std::move(buffer));
+            return loaded;
+        }
+
+        // Read the file at path into buffer. Returns false if it couldn't be read
+        static bool LoadFile(const char *path, std::vector<uint8_t> &buffer)
+        {
+#if defined(_WIN32)
+            HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+            if (file == INVALID_HANDLE_VALUE)
+                return false;
+
+            LARGE_INTEGER size;
+            bool result = false;
+            if (GetFileSizeEx(file, &size))
+            {
+                buffer.resize(static_cast<size_t>(size.QuadPart));
+                DWORD count = 0;
+                result = buffer.empty() || (::ReadFile(file, buffer.data(), static_cast<DWORD>(buffer.size()), &count, nullptr) && count == buffer.size());
+            }
+            CloseHandle(file);
+            return result;
+#else
+            return LoadFileAt(AT_FDCWD, path, buffer);
+#endif
+        }
+
+    private:
+#if !defined(_WIN32)
+        static bool LoadFileAt(int directory, const char *path, std::vector<uint8_t> &buffer)
+        {
+            const int file = ::openat(directory, path, O_RDONLY | O_CLOEXEC);
+            if (file < 0)
+                return false;
+
+            struct stat status;
+            if (::fstat(file, &status) != 0)
+            {
+                ::close(file);
+                return false;
+            }
+
+            // Ask for one byte more than the size. A short read then means the end of the file was reached without a second
+            // read() call. Files that report no size (e.g. in /proc) or that grew keep reading into a larger buffer
+            buffer.resize(static_cast<size_t>(status.st_size) + 1);
+            size_t size = 0;
+            while (true)
+            {
+                const ssize_t count = ::read(file, buffer.data() + size, buffer.size() - size);
+                if (count < 0)
+                {
+                    if (errno == EINTR)
+                        continue;
+
+                    ::close(file);
+                    return false;
+                }
+
+                size += static_cast<size_t>(count);
+                if (count == 0 || size < buffer.size())
+                    break;
+
+                buffer.resize(buffer.size() * 2 + 4096);
+            }
+
+            ::close(file);
+            buffer.resize(size);
+            return true;
+        }
+
+        int directory_ = AT_FDCWD;
+#else
+        std::string directory_;
+#endif
+        std::string path_;
+    };
+
+    // Reads a whole file into a buffer from the calling thread's BufferPool. Reset() loads the next file into the same buffer,
+    // so a reader can be reused for thousands of small files without allocating. Behaves like a MemorySource afterwards.
+    class PooledFileSource : public MemorySource
+    {
+    public:
+        PooledFileSource()
+            : MemorySource(static_cast<const uint8_t *>(nullptr), 0), buffer_(BufferPool::ThreadLocal().Acquire())
+        {
+        }
+
+        // Throws std::runtime_error if the file can't be read
+        explicit PooledFileSource(std::string_view inputPath)
+            : PooledFileSource()
+        {
+            Reset(inputPath);
+        }
+
+        PooledFileSource(const PooledFileSource &) = delete;
+        PooledFileSource &operator=(const PooledFileSource &) = delete;
+
+        ~PooledFileSource()
+        {
+            BufferPool::ThreadLocal().Release(std::move(buffer_));
+        }
+
+        using MemorySource::Reset;
+
+        // Load the file at inputPath into the buffer. Throws std::runtime_error if it can't be read
+        void Reset(std::string_view inputPath)
+        {
+            path_.assign(inputPath);
+            if (!SmallFileLoader::LoadFile(path_.c_str(), buffer_))
+            {
+                buffer_.clear();
+                MemorySource::Reset(buffer_.data(), 0);
+                throw std::runtime_error("PooledFileSource: Failed to read " + path_);
+            }
+            MemorySource::Reset(buffer_.data(), buffer_.size());
+        }
+
+    private:
+        std::vector<uint8_t> buffer_;
+        std::string path_;
+    };
+
+    // Builds a file in a buffer from the calling thread's BufferPool and writes it with one open and write call on Flush(),
+    // Reset() or destruction. Reset() starts the next file in the same buffer.
+    // The destructor can't report errors. Call Flush() before destruction to see write failures.
+    class PooledFileSink
+    {
+    public:
+        PooledFileSink()
+            : buffer_(BufferPool::ThreadLocal().Acquire())
+        {
+        }
+
+        explicit PooledFileSink(std::string_view outputPath)
+            : PooledFileSink()
+        {
+            path_.assign(outputPath);
+            dirty_ = true;
+        }
+
+        PooledFileSink(const PooledFileSink &) = delete;
+        PooledFileSink &operator=(const PooledFileSink &) = delete;
+
+        ~PooledFileSink()
+        {
+            try
+            {
+                Flush();
+            }
+            catch (const std::exception &)
+            {
+            }
+            BufferPool::ThreadLocal().Release(std::move(buffer_));
+        }
+
+        // Write the current file and start a new one at outputPath. Throws std::runtime_error if the current file can't be written
+        void Reset(std::string_view outputPath)
+        {
+            Flush();
+            buffer_.clear();
+            position_ = 0;
+            path_.assign(outputPath);
+            dirty_ = true;
+        }
+
+        size_t Write(const void *data, size_t size)
+        {
+            if (position_ + size > buffer_.size())
+                buffer_.resize(position_ + size);
+
+            if (size > 0)
+                std::memcpy(buffer_.data() + position_, data, size);
+
+            position_ += size;
+            dirty_ = true;
+            return size;
+        }
+
+        // Seeking past the end grows the file with zeros
+        bool Seek(size_t absoluteOffset)
+        {
+            if (absoluteOffset > buffer_.size())
+            {
+                buffer_.resize(absoluteOffset);
+                dirty_ = true;
+            }
+
+            position_ = absoluteOffset;
+            return true;
+        }
+
+        size_t Position() const
+        {
+            return position_;
+        }
+
+        size_t Length() const
+        {
+            return buffer_.size();
+        }
+
+        // Write the buffer to the file if it changed. Throws std::runtime_error on failure
+        void Flush()
+        {
+            if (!dirty_ || path_.empty())
+                return;
+
+#if defined(_WIN32)
+            HANDLE file = CreateFileA(path_.c_str(), GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+            DWORD count = 0;
+            const bool written = file != INVALID_HANDLE_VALUE &&
+                                 (buffer_.empty() || (WriteFile(file, buffer_.data(), static_cast<DWORD>(buffer_.size()), &count, nullptr) && count == buffer_.size()));
+            if (file != INVALID_HANDLE_VALUE)
+                CloseHandle(file);
+#else
+            const int file = ::open(path_.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+            bool written = file >= 0;
+            size_t offset = 0;
+            while (written && offset < buffer_.size())
+            {
+                const ssize_t count = ::write(file, buffer_.data() + offset, buffer_.size() - offset);
+                if (count < 0 && errno == EINTR)
+                    continue;
+
+                written = count > 0;
+                if (written)
+                    offset += static_cast<size_t>(count);
+            }
+            if (file >= 0 && ::close(file) != 0)
+                written = false;
+#endif
+            if (!written)
+                throw std::runtime_error("PooledFileSink: Failed to write " + path_);
+
+            dirty_ = false;
+        }
+
+    private:
+        std::vector<uint8_t> buffer_;
+        std::string path_;
+        size_t position_ = 0;
+        bool dirty_ = false; // Changed since the last Flush()
+    };
+
+    // Reusable reader for many small files. Construct once and Reset(path) onto each file. See PooledFileSource
+    using PooledBinaryReader = BasicBinaryReader<PooledFileSource, NativeEndian, Unchecked>;
+
+    // Reusable writer for many small files. Construct once and Reset(path) onto each file. See PooledFileSink
+    using PooledBinaryWriter = BasicBinaryWriter<PooledFileSink, NativeEndian>;
+}
@@ -0,0 +1,325 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <string_view>
+
+#include <binary_tools/MappedFile.hpp>
+#include <binary_tools/MemoryBuffer.hpp>
+
+namespace binary_tools
+{
+    // Sources are the data providers plugged into BasicBinaryReader. Each one implements:
+    //   size_t Read(void *destination, size_t size)  - Read up to size bytes and advance. Returns the bytes read
+    //   size_t Peek(void *destination, size_t size)  - Same as Read without advancing
+    //   size_t PeekSome(void *destination, size_t size) - Same as Peek, but streaming sources only wait for the first byte
+    //   size_t Skip(size_t size)                     - Advance up to size bytes. Returns the bytes skipped
+    //   bool Seek(size_t absoluteOffset)             - Returns false if the offset can't be reached
+    //   bool CanRead(size_t size)                    - True if at least size more bytes can be read
+    //   bool EndOfStream()
+    //   size_t Position() const
+    //   size_t Length()
+    // IsSeekable is false for forward-only sources. Those can't return to an earlier position after a search.
+    // Sources with IsContiguous == true also provide Current(), Remaining() and Advance() so the reader can access
+    // their bytes directly. Those reads compile down to a bounds check and a memcpy.
+
+    // Reads from a fixed size memory buffer. The buffer must outlive the source
+    class MemorySource
+    {
+    public:
+        static constexpr bool IsContiguous = true;
+        static constexpr bool IsSeekable = true;
+
+        MemorySource(const char *buffer, size_t sizeInBytes)
+        {
+            Reset(buffer, sizeInBytes);
+        }
+
+        MemorySource(const uint8_t *buffer, size_t length)
+        {
+            Reset(buffer, length);
+        }
+
+        void Reset(const char *buffer, size_t sizeInBytes)
+        {
+            Reset(reinterpret_cast<const uint8_t *>(buffer), sizeInBytes);
+        }
+
+        void Reset(const uint8_t *buffer, size_t length)
+        {
+            begin_ = buffer;
+            cursor_ = buffer;
+            end_ = buffer + length;
+        }
+
+        size_t Read(void *destination, size_t size)
+        {
+            const size_t count = std::min(size, Remaining());
+            if (count > 0)
+                std::memcpy(destination, cursor_, count);
+            cursor_ += count;
+            return count;
+        }
+
+        size_t Peek(void *destination, size_t size)
+        {
+            const size_t count = std::min(size, Remaining());
+            if (count > 0)
+                std::memcpy(destination, cursor_, count);
+            return count;
+        }
+
+        size_t PeekSome(void *destination, size_t size)
+        {
+            return Peek(destination, size);
+        }
+
+        size_t Skip(size_t size)
+        {
+            const size_t count = std::min(size, Remaining());
+            cursor_ += count;
+            return count;
+        }
+
+        bool Seek(size_t absoluteOffset)
+        {
+            if (absoluteOffset > Length())
+                return false;
+
+            cursor_ = begin_ + absoluteOffset;
+            return true;
+        }
+
+        bool CanRead(size_t size)
+        {
+            return size <= Remaining();
+        }
+
+        bool EndOfStream()
+        {
+            return cursor_ == end_;
+        }
+
+        size_t Position() const
+        {
+            return cursor_ - begin_;
+        }
+
+        size_t Length() const
+        {
+            return end_ - begin_;
+        }
+
+        const uint8_t *Data() const
+        {
+            return begin_;
+        }
+
+        const uint8_t *Current() const
+        {
+            return cursor_;
+        }
+
+        size_t Remaining() const
+        {
+            return end_ - cursor_;
+        }
+
+        // Move forward without a bounds check. Only used after the caller checked Remaining()
+        void Advance(size_t size)
+        {
+            cursor_ += size;
+        }
+
+    private:
+        const uint8_t *begin_ = nullptr;
+        const uint8_t *cursor_ = nullptr;
+        const uint8_t *end_ = nullptr;
+    };
+
+    // Reads from a read only memory mapping of a file
+    class MappedFileSource : public MemorySource
+    {
+    public:
+        explicit MappedFileSource(std::string_view inputPath)
+            : MemorySource(static_cast<const uint8_t *>(nullptr), 0), file_(inputPath)
+        {
+            MemorySource::Reset(file_.Data(), file_.Size());
+        }
+
+        // Unmap the current file and map the one at inputPath. If that throws the source is left empty
+        void Reset(std::string_view inputPath)
+        {
+            MemorySource::Reset(static_cast<const uint8_t *>(nullptr), 0); // Don't point into the old mapping if Open() throws
+            file_.Open(inputPath);
+            MemorySource::Reset(file_.Data(), file_.Size());
+        }
+
+    private:
+        MappedFile file_;
+    };
+
+    // Reads from a std::istream. Used by BinaryReader for files and for the original memory buffer constructors
+    class StreamSource
+    {
+    public:
+        static constexpr bool IsContiguous = false;
+        static constexpr bool IsSeekable = true;
+
+        // Reads binary data from file at path
+        StreamSource(std::string_view inputPath)
+        {
+            stream_ = new std::ifstream(std::string(inputPath), std::ifstream::in | std::ifstream::binary);
+        }
+
+        // Reads binary data from fixed size memory buffer
+        StreamSource(char *buffer, uint32_t sizeInBytes)
+        {
+            buffer_ = new basic_memstreambuf(buffer, sizeInBytes);
+            stream_ = new std::istream(buffer_);
+        }
+
+        // Reads binary data from fixed size memory buffer
+        StreamSource(uint8_t *buffer, std::size_t length)
+        {
+            buffer_ = new basic_memstreambuf((char *)buffer, length);
+            stream_ = new std::istream(buffer_);
+        }
+
+        StreamSource(const StreamSource &) = delete;
+        StreamSource &operator=(const StreamSource &) = delete;
+
+        ~StreamSource()
+        {
+            delete stream_;
+            if (buffer_)
+                delete buffer_;
+        }
+
+        // Read from the file at path. The std::ifstream is reused if the source was already reading a file
+        void Reset(std::string_view inputPath)
+        {
+            if (buffer_)
+            {
+                delete stream_;
+                delete buffer_;
+                buffer_ = nullptr;
+                stream_ = new std::ifstream(std::string(inputPath), std::ifstream::in | std::ifstream::binary);
+                return;
+            }
+
+            std::ifstream *file = static_cast<std::ifstream *>(stream_);
+            file->close();
+            file->clear();
+            file->open(std::string(inputPath), std::ifstream::in | std::ifstream::binary);
+        }
+
+        // Read from a fixed size memory buffer. The stream buffer is reused if the source was already reading memory
+        void Reset(char *buffer, uint32_t sizeInBytes)
+        {
+            Reset(reinterpret_cast<uint8_t *>(buffer), static_cast<size_t>(sizeInBytes));
+        }
+
+        void Reset(uint8_t *buffer, std::size_t length)
+        {
+            if (!buffer_)
+            {
+                delete stream_;
+                buffer_ = new basic_memstreambuf((char *)buffer, length);
+                stream_ = new std::istream(buffer_);
+                return;
+            }
+
+            buffer_->reset((char *)buffer, length);
+            stream_->clear();
+        }
+
+        size_t Read(void *destination, size_t size)
+        {
+            stream_->read(static_cast<char *>(destination), size);
+            return static_cast<size_t>(stream_->gcount());
+        }
+
+        size_t Peek(void *destination, size_t size)
+        {
+            const std::streampos start = stream_->tellg();
+            stream_->read(static_cast<char *>(destination), size);
+            const size_t count = static_cast<size_t>(stream_->gcount());
+
+            // Hitting the end while peeking shouldn't break the next read
+            stream_->clear();
+            stream_->seekg(start);
+            return count;
+        }
+
+        // Files and memory buffers never wait for data
+        size_t PeekSome(void *destination, size_t size)
+        {
+            return Peek(destination, size);
+        }
+
+        size_t Skip(size_t size)
+        {
+            stream_->seekg(size, std::ifstream::cur);
+            if (!stream_->fail())
+                return size;
+
+            // Memory streams can't seek past the end. Stop at the end instead
+            stream_->clear();
+            const size_t start = Position();
+            stream_->seekg(0, std::ios::end);
+            return Position() - start;
+        }
+
+        bool Seek(size_t absoluteOffset)
+        {
+            stream_->clear(); // Reading up to the end sets eofbit/failbit, which would make the seek fail
+            stream_->seekg(absoluteOffset, std::ifstream::beg);
+            return !stream_->fail();
+        }
+
+        bool CanRead(size_t size)
+        {
+            const size_t position = Position();
+            const size_t length = Length();
+            return position <= length && size <= length - position;
+        }
+
+        bool EndOfStream()
+        {
+            if (stream_->peek() != std::istream::traits_type::eof())
+                return false;
+
+            stream_->clear(stream_->rdstate() & ~std::ios::eofbit);
+            return true;
+        }
+
+        size_t Position() const
+        {
+            return stream_->tellg();
+        }
+
+        size_t Length()
+        {
+            // Save current position
+            size_t realPosition = Position();
+
+            // Seek to end of file and get position (the length)
+            stream_->seekg(0, std::ios::end);
+            size_t endPosition = Position();
+
+            // Seek back to real pos and return length
+            if (realPosition != endPosition)
+                Seek(realPosition);
+
+            return endPosition;
+        }
+
+    private:
+        std::istream *stream_ = nullptr;
+        basic_memstreambuf *buffer_ = nullptr;
+    };
+}
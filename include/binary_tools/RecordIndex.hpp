@@ -0,0 +1,337 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <binary_tools/BinaryWriter.hpp>
+#include <binary_tools/MappedFile.hpp>
+
+namespace binary_tools
+{
+    // Location of one record inside a file
+    struct RecordIndexEntry
+    {
+        uint64_t Key = 0;
+        uint64_t Offset = 0;
+        uint64_t Size = 0;
+    };
+
+    // Header at the start of a record index sidecar file. Followed by the entries and then the hash table slots
+    struct RecordIndexHeader
+    {
+        static constexpr uint32_t ExpectedSignature = 0x58444952; // "RIDX"
+        static constexpr uint32_t ExpectedVersion = 1;
+
+        uint32_t Signature = ExpectedSignature;
+        uint32_t Version = ExpectedVersion;
+        uint64_t SourceSize = 0;
+        int64_t SourceWriteTime = 0;
+        uint64_t SourceSampleHash = 0; // Hash of the first and last SampleSize bytes of the source file
+        uint64_t EntryCount = 0;
+        uint64_t SlotCount = 0;
+        uint64_t PayloadHash = 0; // Hash of the entries and slots
+    };
+
+    inline uint64_t Mix64(uint64_t value)
+    {
+        value ^= value >> 33;
+        value *= 0xFF51AFD7ED558CCDull;
+        value ^= value >> 33;
+        value *= 0xC4CEB9FE1A85EC53ull;
+        value ^= value >> 33;
+        return value;
+    }
+
+    // Fast non cryptographic 64 bit hash. Used to validate sidecar files, not for security
+    inline uint64_t HashBytes(const void *data, size_t size, uint64_t seed = 0)
+    {
+        const uint8_t *bytes = static_cast<const uint8_t *>(data);
+        uint64_t hash = seed ^ (size * 0x9E3779B97F4A7C15ull);
+        size_t i = 0;
+        for (; i + 8 <= size; i += 8)
+        {
+            uint64_t word;
+            std::memcpy(&word, bytes + i, 8);
+            hash = (hash ^ Mix64(word)) * 0x9E3779B97F4A7C15ull;
+        }
+
+        uint64_t tail = 0;
+        if (i < size)
+            std::memcpy(&tail, bytes + i, size - i);
+
+        return Mix64(hash ^ Mix64(tail));
+    }
+
+    // Index of (key, offset, size) records that can be saved next to the file it describes and memory mapped on later runs.
+    // Build it with a single pass over the file, then Save() it. Load() validates the sidecar against the size, write time
+    // and a sampled hash of the source file so a stale index is never used. Find() is an O(1) hash table lookup either way.
+    class RecordIndex
+    {
+    public:
+        static constexpr size_t SampleSize = 64 * 1024;
+
+        RecordIndex() = default;
+
+        explicit RecordIndex(std::vector<RecordIndexEntry> entries)
+            : ownedEntries_(std::move(entries))
+        {
+            if (ownedEntries_.size() >= UINT32_MAX)
+                throw std::length_error("RecordIndex: Too many records");
+
+            // Open addressing with linear probing. At most half full so probes stay short
+            size_t slotCount = ownedEntries_.empty() ? 0 : 2;
+            while (slotCount < ownedEntries_.size() * 2)
+                slotCount *= 2;
+
+            ownedSlots_.assign(slotCount, 0);
+            for (size_t i = 0; i < ownedEntries_.size(); i++)
+            {
+                size_t slot = Mix64(ownedEntries_[i].Key) & (slotCount - 1);
+                while (ownedSlots_[slot] != 0)
+                    slot = (slot + 1) & (slotCount - 1);
+
+                ownedSlots_[slot] = static_cast<uint32_t>(i + 1);
+            }
+
+            entries_ = ownedEntries_.data();
+            entryCount_ = ownedEntries_.size();
+            slots_ = ownedSlots_.data();
+            slotCount_ = slotCount;
+        }
+
+        // Build an index in one pass. nextRecord(reader, entry) fills in the next record and returns false once there are no more
+        template <typename Reader, typename NextRecord>
+        static RecordIndex Build(Reader &reader, NextRecord &&nextRecord)
+        {
+            std::vector<RecordIndexEntry> entries;
+            RecordIndexEntry entry;
+            while (nextRecord(reader, entry))
+                entries.push_back(entry);
+
+            return RecordIndex(std::move(entries));
+        }
+
+        // Map a sidecar file. Returns std::nullopt if it's missing, corrupt or doesn't match the current source file.
+        // verifyPayload also hashes the entries. That touches the whole sidecar, so it's off by default.
+        static std::optional<RecordIndex> Load(std::string_view sidecarPath, std::string_view sourcePath, bool verifyPayload = false)
+        {
+            RecordIndex index;
+            try
+            {
+                index.file_.Open(sidecarPath);
+            }
+            catch (const std::exception &)
+            {
+                return std::nullopt;
+            }
+
+            const uint8_t *data = index.file_.Data();
+            const size_t size = index.file_.Size();
+            if (size < sizeof(RecordIndexHeader))
+                return std::nullopt;
+
+            RecordIndexHeader header;
+            std::memcpy(&header, data, sizeof(header));
+            if (header.Signature != RecordIndexHeader::ExpectedSignature || header.Version != RecordIndexHeader::ExpectedVersion)
+                return std::nullopt;
+
+            // Check sizes before any multiplication can overflow
+            if (header.EntryCount >= UINT32_MAX || header.SlotCount > (size_t(1) << 33) || (header.SlotCount & (header.SlotCount - 1)) != 0)
+                return std::nullopt;
+
+            const size_t payloadSize = header.EntryCount * sizeof(RecordIndexEntry) + header.SlotCount * sizeof(uint32_t);
+            if (size != sizeof(RecordIndexHeader) + payloadSize || (header.EntryCount > 0 && header.SlotCount < header.EntryCount * 2))
+                return std::nullopt;
+
+            std::optional<RecordIndexHeader> sourceHeader = DescribeSource(sourcePath);
+            if (!sourceHeader || sourceHeader->SourceSize != header.SourceSize || sourceHeader->SourceWriteTime != header.SourceWriteTime ||
+                sourceHeader->SourceSampleHash != header.SourceSampleHash)
+                return std::nullopt;
+
+            const uint8_t *payload = data + sizeof(RecordIndexHeader);
+            if (verifyPayload && HashBytes(payload, payloadSize) != header.PayloadHash)
+                return std::nullopt;
+
+            // The header is a multiple of 8 bytes and mappings are page aligned, so entries are suitably aligned
+            index.entries_ = reinterpret_cast<const RecordIndexEntry *>(payload);
+            index.entryCount_ = header.EntryCount;
+            index.slots_ = reinterpret_cast<const uint32_t *>(payload + header.EntryCount * sizeof(RecordIndexEntry));
+            index.slotCount_ = header.SlotCount;
+            return index;
+        }
+
+        // Write the index to sidecarPath, tagged with the current state of the source file. Throws std::runtime_error on failure.
+        // Written to a temporary file first and renamed so readers never see a partial sidecar.
+        void Save(std::string_view sidecarPath, std::string_view sourcePath) const
+        {
+            std::optional<RecordIndexHeader> header = DescribeSource(sourcePath);
+            if (!header)
+                throw std::runtime_error("RecordIndex::Save: Failed to read source file " + std::string(sourcePath));
+
+            header->EntryCount = entryCount_;
+            header->SlotCount = slotCount_;
+            header->PayloadHash = PayloadHash();
+
+            const std::string tempPath = std::string(sidecarPath) + ".tmp";
+            bool written;
+            {
+                BinaryWriter writer(tempPath);
+                writer.Write(*header);
+                writer.WriteFromMemory(entries_, entryCount_ * sizeof(RecordIndexEntry));
+                writer.WriteFromMemory(slots_, slotCount_ * sizeof(uint32_t));
+                writer.Flush();
+                written = writer.Position() == sizeof(RecordIndexHeader) + entryCount_ * sizeof(RecordIndexEntry) + slotCount_ * sizeof(uint32_t);
+            }
+
+            // Don't leave the temp file behind on failure
+            std::error_code error;
+            if (!written)
+            {
+                std::filesystem::remove(tempPath, error);
+                throw std::runtime_error("RecordIndex::Save: Failed to write " + tempPath);
+            }
+
+            std::filesystem::rename(tempPath, std::string(sidecarPath), error);
+            if (error)
+            {
+                const std::string message = error.message();
+                std::filesystem::remove(tempPath, error);
+                throw std::runtime_error("RecordIndex::Save: Failed to replace " + std::string(sidecarPath) + ": " + message);
+            }
+        }
+
+        // Load the sidecar if it's valid, otherwise call build() and try to save the result for next time.
+        // Failing to write the sidecar (e.g. read only directory) isn't an error.
+        template <typename BuildIndex>
+        static RecordIndex LoadOrBuild(std::string_view sidecarPath, std::string_view sourcePath, BuildIndex &&build)
+        {
+            if (std::optional<RecordIndex> loaded = Load(sidecarPath, sourcePath))
+                return std::move(*loaded);
+
+            RecordIndex index = build();
+            try
+            {
+                index.Save(sidecarPath, sourcePath);
+            }
+            catch (const std::exception &)
+            {
+            }
+            return index;
+        }
+
+        // Returns the record with key, or nullptr. If keys repeat this is the first record added with that key
+        const RecordIndexEntry *Find(uint64_t key) const
+        {
+            if (slotCount_ == 0)
+                return nullptr;
+
+            // Probes and entry indices are bounded so a damaged sidecar loaded without verifyPayload can't read out of bounds
+            size_t slot = Mix64(key) & (slotCount_ - 1);
+            for (size_t probes = 0; probes < slotCount_ && slots_[slot] != 0; probes++)
+            {
+                const size_t entryIndex = slots_[slot] - 1;
+                if (entryIndex < entryCount_ && entries_[entryIndex].Key == key)
+                    return &entries_[entryIndex];
+
+                slot = (slot + 1) & (slotCount_ - 1);
+            }
+            return nullptr;
+        }
+
+        size_t Size() const
+        {
+            return entryCount_;
+        }
+
+        // True if the entries are memory mapped from a sidecar rather than built in memory
+        bool IsMapped() const
+        {
+            return file_.IsOpen();
+        }
+
+        const RecordIndexEntry &operator[](size_t index) const
+        {
+            return entries_[index];
+        }
+
+        const RecordIndexEntry *begin() const
+        {
+            return entries_;
+        }
+
+        const RecordIndexEntry *end() const
+        {
+            return entries_ + entryCount_;
+        }
+
+    private:
+        // Fill in the source fields of a header from the file at sourcePath
+        static std::optional<RecordIndexHeader> DescribeSource(std::string_view sourcePath)
+        {
+            const std::filesystem::path path(sourcePath);
+            std::error_code error;
+            const uintmax_t size = std::filesystem::file_size(path, error);
+            if (error)
+                return std::nullopt;
+
+            const auto writeTime = std::filesystem::last_write_time(path, error);
+            if (error)
+                return std::nullopt;
+
+            RecordIndexHeader header;
+            header.SourceSize = size;
+            header.SourceWriteTime = static_cast<int64_t>(writeTime.time_since_epoch().count());
+
+            // Hash the start and end of the file. Catches rewrites that keep the size and write time without reading the whole file
+            std::ifstream file(path, std::ios::in | std::ios::binary);
+            if (!file.is_open())
+                return std::nullopt;
+
+            std::vector<char> sample(static_cast<size_t>(std::min<uintmax_t>(size, SampleSize * 2)));
+            const size_t headSize = std::min(sample.size(), SampleSize);
+            file.read(sample.data(), headSize);
+            if (sample.size() > headSize)
+            {
+                file.seekg(static_cast<std::streamoff>(size - (sample.size() - headSize)));
+                file.read(sample.data() + headSize, sample.size() - headSize);
+            }
+            if (!file)
+                return std::nullopt;
+
+            header.SourceSampleHash = HashBytes(sample.data(), sample.size(), size);
+            return header;
+        }
+
+        uint64_t PayloadHash() const
+        {
+            // Hashed as one contiguous block to match Load()
+            std::vector<uint8_t> payload(entryCount_ * sizeof(RecordIndexEntry) + slotCount_ * sizeof(uint32_t));
+            if (!payload.empty())
+            {
+                std::memcpy(payload.data(), entries_, entryCount_ * sizeof(RecordIndexEntry));
+                std::memcpy(payload.data() + entryCount_ * sizeof(RecordIndexEntry), slots_, slotCount_ * sizeof(uint32_t));
+            }
+            return HashBytes(payload.data(), payload.size());
+        }
+
+        std::vector<RecordIndexEntry> ownedEntries_;
+        std::vector<uint32_t> ownedSlots_;
+        MappedFile file_;
+
+        // Point at either the owned vectors or the mapped sidecar
+        const RecordIndexEntry *entries_ = nullptr;
+        size_t entryCount_ = 0;
+        const uint32_t *slots_ = nullptr;
+        size_t slotCount_ = 0;
+    };
+}
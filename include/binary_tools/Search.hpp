@@ -0,0 +1,153 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+
+#include <binary_tools/Simd.hpp>
+
+namespace binary_tools
+{
+    // Returned by the search helpers when nothing was found
+    constexpr size_t NotFound = static_cast<size_t>(-1);
+
+    // Returns the offset of the first occurrence of needle in haystack, or NotFound.
+    // Candidates are filtered by comparing the first and last byte of the needle 16 or 32 positions at a time,
+    // so only positions where both match are compared in full.
+    inline size_t FindBytes(const uint8_t *haystack, size_t size, const uint8_t *needle, size_t needleSize)
+    {
+        if (needleSize == 0)
+            return 0;
+        if (needleSize > size)
+            return NotFound;
+        if (needleSize == 1)
+        {
+            const void *match = std::memchr(haystack, needle[0], size);
+            return match ? static_cast<const uint8_t *>(match) - haystack : NotFound;
+        }
+
+        const size_t lastStart = size - needleSize; // Last position a match can start at
+        size_t i = 0;
+#if defined(BINARY_TOOLS_AVX2)
+        {
+            const __m256i first = _mm256_set1_epi8(static_cast<char>(needle[0]));
+            const __m256i last = _mm256_set1_epi8(static_cast<char>(needle[needleSize - 1]));
+            for (; i + 32 <= lastStart + 1; i += 32)
+            {
+                const __m256i blockFirst = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(haystack + i));
+                const __m256i blockLast = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(haystack + i + needleSize - 1));
+                uint32_t mask = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_and_si256(_mm256_cmpeq_epi8(blockFirst, first), _mm256_cmpeq_epi8(blockLast, last))));
+                while (mask != 0)
+                {
+                    const size_t candidate = i + CountTrailingZeros(mask);
+                    if (std::memcmp(haystack + candidate + 1, needle + 1, needleSize - 2) == 0)
+                        return candidate;
+
+                    mask &= mask - 1;
+                }
+            }
+        }
+#endif
+#if defined(BINARY_TOOLS_SSE2)
+        {
+            const __m128i first = _mm_set1_epi8(static_cast<char>(needle[0]));
+            const __m128i last = _mm_set1_epi8(static_cast<char>(needle[needleSize - 1]));
+            for (; i + 16 <= lastStart + 1; i += 16)
+            {
+                const __m128i blockFirst = _mm_loadu_si128(reinterpret_cast<const __m128i *>(haystack + i));
+                const __m128i blockLast = _mm_loadu_si128(reinterpret_cast<const __m128i *>(haystack + i + needleSize - 1));
+                uint32_t mask = static_cast<uint32_t>(_mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(blockFirst, first), _mm_cmpeq_epi8(blockLast, last))));
+                while (mask != 0)
+                {
+                    const size_t candidate = i + CountTrailingZeros(mask);
+                    if (std::memcmp(haystack + candidate + 1, needle + 1, needleSize - 2) == 0)
+                        return candidate;
+
+                    mask &= mask - 1;
+                }
+            }
+        }
+#endif
+        while (i <= lastStart)
+        {
+            const void *match = std::memchr(haystack + i, needle[0], lastStart + 1 - i);
+            if (!match)
+                return NotFound;
+
+            const size_t candidate = static_cast<const uint8_t *>(match) - haystack;
+            if (std::memcmp(haystack + candidate, needle, needleSize) == 0)
+                return candidate;
+
+            i = candidate + 1;
+        }
+        return NotFound;
+    }
+
+    // Returns the offset of the first occurrence of value that starts at a multiple of alignment, or NotFound.
+    // baseOffset is the absolute offset of data[0], so alignment is relative to the start of the file or buffer rather than data.
+    // Small power of two alignments compare a whole SIMD register of candidates at once.
+    inline size_t FindAligned(const uint8_t *data, size_t size, size_t baseOffset, const uint8_t *value, size_t valueSize, size_t alignment)
+    {
+        if (alignment == 0 || valueSize == 0 || valueSize > size)
+            return NotFound;
+
+        // First position that's aligned
+        const size_t remainder = baseOffset % alignment;
+        size_t i = remainder > 0 ? alignment - remainder : 0;
+        const size_t lastStart = size - valueSize;
+
+#if defined(BINARY_TOOLS_SSE2)
+        const bool powerOfTwo = (alignment & (alignment - 1)) == 0;
+        if (powerOfTwo && alignment <= 16 && valueSize <= alignment && (alignment % valueSize) == 0)
+        {
+            // Repeat the value every alignment bytes. Unused bytes between values are masked out below
+            alignas(32) uint8_t pattern[32] = {};
+            for (size_t offset = 0; offset < 32; offset += alignment)
+                std::memcpy(pattern + offset, value, valueSize);
+
+            // Bits of the byte compare mask that have to be set for a match at each aligned position
+            uint32_t valueBits = (valueSize >= 32) ? 0xFFFFFFFFu : ((1u << valueSize) - 1);
+            uint32_t matchMask = 0;
+            for (size_t offset = 0; offset < 32; offset += alignment)
+                matchMask |= valueBits << offset;
+
+#if defined(BINARY_TOOLS_AVX2)
+            const __m256i pattern256 = _mm256_load_si256(reinterpret_cast<const __m256i *>(pattern));
+            for (; i + 32 <= lastStart + valueSize; i += 32)
+            {
+                const __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + i));
+                const uint32_t equal = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(block, pattern256)));
+                if ((equal & matchMask) == 0)
+                    continue;
+
+                for (size_t offset = 0; offset < 32; offset += alignment)
+                {
+                    if (((equal >> offset) & valueBits) == valueBits)
+                        return i + offset;
+                }
+            }
+#endif
+            const __m128i pattern128 = _mm_load_si128(reinterpret_cast<const __m128i *>(pattern));
+            const uint32_t matchMask128 = matchMask & 0xFFFF;
+            for (; i + 16 <= lastStart + valueSize; i += 16)
+            {
+                const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i));
+                const uint32_t equal = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(block, pattern128)));
+                if ((equal & matchMask128) == 0)
+                    continue;
+
+                for (size_t offset = 0; offset < 16; offset += alignment)
+                {
+                    if (((equal >> offset) & valueBits) == valueBits)
+                        return i + offset;
+                }
+            }
+        }
+#endif
+        for (; i <= lastStart; i += alignment)
+        {
+            if (std::memcmp(data + i, value, valueSize) == 0)
+                return i;
+        }
+        return NotFound;
+    }
+}
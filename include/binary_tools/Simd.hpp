@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstdint>
+
+// Compile time detection of the instruction sets used by the vectorized helpers.
+// Everything has a scalar fallback, so building without these flags only costs speed.
+#if defined(__AVX2__)
+#define BINARY_TOOLS_AVX2 1
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define BINARY_TOOLS_SSE2 1
+#endif
+
+// MSVC doesn't define __F16C__. Every CPU with AVX2 also has F16C
+#if defined(__F16C__) || (defined(_MSC_VER) && defined(__AVX2__))
+#define BINARY_TOOLS_F16C 1
+#endif
+
+#if defined(BINARY_TOOLS_SSE2) || defined(BINARY_TOOLS_AVX2)
+#include <immintrin.h>
+#endif
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace binary_tools
+{
+    // Index of the lowest set bit. value must not be zero
+    inline uint32_t CountTrailingZeros(uint32_t value)
+    {
+#if defined(_MSC_VER)
+        unsigned long index;
+        _BitScanForward(&index, value);
+        return index;
+#else
+        return static_cast<uint32_t>(__builtin_ctz(value));
+#endif
+    }
+}
@@ -0,0 +1,257 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+
+#include <binary_tools/Endian.hpp>
+#include <binary_tools/Simd.hpp>
+
+namespace binary_tools
+{
+    // Helpers for UTF-16 strings stored as raw bytes. They work on unaligned data in either byte order.
+    // swap == true means the data is in the opposite byte order of the host.
+    // Unpaired surrogates are replaced with U+FFFD when transcoding to UTF-8, and invalid UTF-8 is replaced with U+FFFD when transcoding to UTF-16.
+
+    // Returns the index of the first zero code unit in data, or maxUnits if there isn't one
+    inline size_t FindUtf16Terminator(const uint8_t *data, size_t maxUnits)
+    {
+        size_t i = 0;
+#if defined(BINARY_TOOLS_AVX2)
+        const __m256i zero256 = _mm256_setzero_si256();
+        for (; i + 16 <= maxUnits; i += 16)
+        {
+            const __m256i units = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + i * 2));
+            const uint32_t mask = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi16(units, zero256)));
+            if (mask != 0)
+                return i + CountTrailingZeros(mask) / 2;
+        }
+#endif
+#if defined(BINARY_TOOLS_SSE2)
+        const __m128i zero128 = _mm_setzero_si128();
+        for (; i + 8 <= maxUnits; i += 8)
+        {
+            const __m128i units = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i * 2));
+            const uint32_t mask = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi16(units, zero128)));
+            if (mask != 0)
+                return i + CountTrailingZeros(mask) / 2;
+        }
+#endif
+        for (; i < maxUnits; i++)
+        {
+            if (data[i * 2] == 0 && data[i * 2 + 1] == 0)
+                return i;
+        }
+        return maxUnits;
+    }
+
+    // Copy count code units into a host byte order UTF-16 string
+    inline std::u16string Utf16ToU16String(const uint8_t *data, size_t count, bool swap)
+    {
+        std::u16string output(count, u'\0');
+        if (count > 0)
+            std::memcpy(output.data(), data, count * 2);
+        if (swap)
+        {
+            for (char16_t &unit : output)
+                unit = static_cast<char16_t>(ByteSwap16(static_cast<uint16_t>(unit)));
+        }
+        return output;
+    }
+
+    // Transcode count code units of UTF-16 to UTF-8. Runs of ASCII are converted 8 or 16 units at a time
+    inline std::string Utf16ToUtf8(const uint8_t *data, size_t count, bool swap)
+    {
+        // Worst case is 3 bytes per unit. Surrogate pairs are 4 bytes per 2 units
+        std::string output(count * 3, '\0');
+        uint8_t *out = reinterpret_cast<uint8_t *>(output.data());
+
+        size_t i = 0;
+        while (i < count)
+        {
+#if defined(BINARY_TOOLS_AVX2)
+            while (i + 16 <= count)
+            {
+                __m256i units = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + i * 2));
+                if (swap)
+                    units = _mm256_or_si256(_mm256_slli_epi16(units, 8), _mm256_srli_epi16(units, 8));
+                if (!_mm256_testz_si256(units, _mm256_set1_epi16(static_cast<short>(0xFF80))))
+                    break;
+
+                // packus works per 128 bit lane. Gather the low 8 bytes of each lane into the first 16 bytes
+                const __m256i packed = _mm256_permute4x64_epi64(_mm256_packus_epi16(units, units), 0b1000);
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(out), _mm256_castsi256_si128(packed));
+                out += 16;
+                i += 16;
+            }
+#endif
+#if defined(BINARY_TOOLS_SSE2)
+            while (i + 8 <= count)
+            {
+                __m128i units = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i * 2));
+                if (swap)
+                    units = _mm_or_si128(_mm_slli_epi16(units, 8), _mm_srli_epi16(units, 8));
+                const __m128i nonAscii = _mm_and_si128(units, _mm_set1_epi16(static_cast<short>(0xFF80)));
+                if (_mm_movemask_epi8(_mm_cmpeq_epi8(nonAscii, _mm_setzero_si128())) != 0xFFFF)
+                    break;
+
+                _mm_storel_epi64(reinterpret_cast<__m128i *>(out), _mm_packus_epi16(units, units));
+                out += 8;
+                i += 8;
+            }
+#endif
+            // Scalar path for the rest of a block that has non ASCII characters. Goes back to the SIMD loop after
+            const size_t blockEnd = (i + 16 < count) ? i + 16 : count;
+            while (i < blockEnd)
+            {
+                uint16_t unit;
+                std::memcpy(&unit, data + i * 2, 2);
+                if (swap)
+                    unit = ByteSwap16(unit);
+                i++;
+
+                if (unit < 0x80)
+                {
+                    *out++ = static_cast<uint8_t>(unit);
+                }
+                else if (unit < 0x800)
+                {
+                    *out++ = static_cast<uint8_t>(0xC0 | (unit >> 6));
+                    *out++ = static_cast<uint8_t>(0x80 | (unit & 0x3F));
+                }
+                else if (unit >= 0xD800 && unit <= 0xDFFF)
+                {
+                    uint16_t next = 0;
+                    if (i < count)
+                    {
+                        std::memcpy(&next, data + i * 2, 2);
+                        if (swap)
+                            next = ByteSwap16(next);
+                    }
+
+                    if (unit <= 0xDBFF && next >= 0xDC00 && next <= 0xDFFF)
+                    {
+                        const uint32_t codePoint = 0x10000 + ((static_cast<uint32_t>(unit) - 0xD800) << 10) + (next - 0xDC00);
+                        *out++ = static_cast<uint8_t>(0xF0 | (codePoint >> 18));
+                        *out++ = static_cast<uint8_t>(0x80 | ((codePoint >> 12) & 0x3F));
+                        *out++ = static_cast<uint8_t>(0x80 | ((codePoint >> 6) & 0x3F));
+                        *out++ = static_cast<uint8_t>(0x80 | (codePoint & 0x3F));
+                        i++;
+                    }
+                    else
+                    {
+                        // Unpaired surrogate. Write U+FFFD
+                        *out++ = 0xEF;
+                        *out++ = 0xBF;
+                        *out++ = 0xBD;
+                    }
+                }
+                else
+                {
+                    *out++ = static_cast<uint8_t>(0xE0 | (unit >> 12));
+                    *out++ = static_cast<uint8_t>(0x80 | ((unit >> 6) & 0x3F));
+                    *out++ = static_cast<uint8_t>(0x80 | (unit & 0x3F));
+                }
+            }
+        }
+
+        output.resize(out - reinterpret_cast<uint8_t *>(output.data()));
+        return output;
+    }
+
+    // Transcode UTF-8 to host byte order UTF-16
+    inline std::u16string Utf8ToU16String(std::string_view input)
+    {
+        std::u16string output(input.size(), u'\0'); // Never more units than bytes
+        char16_t *out = output.data();
+        const uint8_t *data = reinterpret_cast<const uint8_t *>(input.data());
+        const size_t size = input.size();
+
+        size_t i = 0;
+        while (i < size)
+        {
+#if defined(BINARY_TOOLS_SSE2)
+            // Widen 16 bytes of ASCII at a time
+            while (i + 16 <= size)
+            {
+                const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i));
+                if (_mm_movemask_epi8(bytes) != 0)
+                    break;
+
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(out), _mm_unpacklo_epi8(bytes, _mm_setzero_si128()));
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(out + 8), _mm_unpackhi_epi8(bytes, _mm_setzero_si128()));
+                out += 16;
+                i += 16;
+            }
+            if (i >= size)
+                break;
+#endif
+            const uint8_t lead = data[i];
+            uint32_t codePoint = 0xFFFD;
+            size_t length = 1;
+            if (lead < 0x80)
+            {
+                codePoint = lead;
+            }
+            else if (lead >= 0xC2 && lead <= 0xF4)
+            {
+                const size_t expected = lead < 0xE0 ? 2 : (lead < 0xF0 ? 3 : 4);
+                uint32_t value = lead & (0x7F >> expected);
+                size_t j = 1;
+                for (; j < expected && i + j < size && (data[i + j] & 0xC0) == 0x80; j++)
+                    value = (value << 6) | (data[i + j] & 0x3F);
+
+                length = j;
+                const bool overlong = (expected == 3 && value < 0x800) || (expected == 4 && value < 0x10000);
+                if (j == expected && !overlong && value <= 0x10FFFF && !(value >= 0xD800 && value <= 0xDFFF))
+                    codePoint = value;
+            }
+            i += length;
+
+            if (codePoint >= 0x10000)
+            {
+                codePoint -= 0x10000;
+                *out++ = static_cast<char16_t>(0xD800 + (codePoint >> 10));
+                *out++ = static_cast<char16_t>(0xDC00 + (codePoint & 0x3FF));
+            }
+            else
+            {
+                *out++ = static_cast<char16_t>(codePoint);
+            }
+        }
+
+        output.resize(out - output.data());
+        return output;
+    }
+
+    // Convert host byte order UTF-16 to a wide string. Surrogate pairs are combined when wchar_t is 4 bytes (Linux).
+    // Unpaired surrogates are kept as is so no data is lost. On Windows wchar_t is UTF-16 and units are copied directly
+    inline std::wstring U16StringToWString(std::u16string_view input)
+    {
+        if constexpr (sizeof(wchar_t) == 2)
+        {
+            return std::wstring(input.begin(), input.end());
+        }
+        else
+        {
+            std::wstring output;
+            output.reserve(input.size());
+            for (size_t i = 0; i < input.size(); i++)
+            {
+                const char16_t unit = input[i];
+                if (unit >= 0xD800 && unit <= 0xDBFF && i + 1 < input.size() && input[i + 1] >= 0xDC00 && input[i + 1] <= 0xDFFF)
+                {
+                    const uint32_t codePoint = 0x10000 + ((static_cast<uint32_t>(unit) - 0xD800) << 10) + (input[i + 1] - 0xDC00);
+                    output.push_back(static_cast<wchar_t>(codePoint));
+                    i++;
+                }
+                else
+                {
+                    output.push_back(static_cast<wchar_t>(unit));
+                }
+            }
+            return output;
+        }
+    }
+}
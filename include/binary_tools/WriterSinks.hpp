@@ -0,0 +1,289 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <binary_tools/MemoryBuffer.hpp>
+
+namespace binary_tools
+{
+    // Sinks are the data consumers plugged into BasicBinaryWriter. Each one implements:
+    //   size_t Write(const void *data, size_t size) - Write size bytes at the current position. Returns the bytes written
+    //   bool Seek(size_t absoluteOffset)            - Returns false if the offset can't be reached
+    //   size_t Position() const
+    //   size_t Length()
+    //   void Flush()
+
+    // Writes to a std::ostream. Used by BinaryWriter for files and fixed size memory buffers
+    class StreamSink
+    {
+    public:
+        // Writes binary data from file at path. If truncate == true any existing file contents will be cleared
+        StreamSink(std::string_view inputPath, bool truncate = true)
+        {
+            stream_ = new std::ofstream(std::string(inputPath), OpenFlags(inputPath, truncate));
+        }
+
+        // Writes binary data from fixed size memory buffer
+        StreamSink(char *buffer, uint32_t sizeInBytes)
+        {
+            buffer_ = new MemoryBuffer(buffer, sizeInBytes);
+            stream_ = new std::ostream(buffer_);
+        }
+
+        StreamSink(const StreamSink &) = delete;
+        StreamSink &operator=(const StreamSink &) = delete;
+
+        ~StreamSink()
+        {
+            delete stream_;
+            if (buffer_)
+                delete buffer_;
+        }
+
+        // Write to the file at path. The current file is flushed and closed. The std::ofstream is reused if the sink was already writing a file
+        void Reset(std::string_view inputPath, bool truncate = true)
+        {
+            if (buffer_)
+            {
+                delete stream_;
+                delete buffer_;
+                buffer_ = nullptr;
+                stream_ = new std::ofstream(std::string(inputPath), OpenFlags(inputPath, truncate));
+                return;
+            }
+
+            std::ofstream *file = static_cast<std::ofstream *>(stream_);
+            file->close();
+            file->clear();
+            file->open(std::string(inputPath), OpenFlags(inputPath, truncate));
+        }
+
+        // Write to a fixed size memory buffer. The stream buffer is reused if the sink was already writing to memory
+        void Reset(char *buffer, uint32_t sizeInBytes)
+        {
+            if (!buffer_)
+            {
+                delete stream_;
+                buffer_ = new MemoryBuffer(buffer, sizeInBytes);
+                stream_ = new std::ostream(buffer_);
+                return;
+            }
+
+            buffer_->Reset(buffer, sizeInBytes);
+            stream_->clear();
+        }
+
+        size_t Write(const void *data, size_t size)
+        {
+            stream_->write(static_cast<const char *>(data), size);
+            return stream_->good() ? size : 0;
+        }
+
+        bool Seek(size_t absoluteOffset)
+        {
+            stream_->seekp(absoluteOffset, std::ofstream::beg);
+            return !stream_->fail();
+        }
+
+        size_t Position() const
+        {
+            return stream_->tellp();
+        }
+
+        size_t Length()
+        {
+            // Save current position
+            size_t realPosition = Position();
+
+            // Seek to end of file and get position (the length)
+            stream_->seekp(0, std::ios::end);
+            size_t endPosition = Position();
+
+            // Seek back to real pos and return length
+            if (realPosition != endPosition)
+                Seek(realPosition);
+
+            return endPosition;
+        }
+
+        void Flush()
+        {
+            stream_->flush();
+        }
+
+    private:
+        static std::ios_base::openmode OpenFlags(std::string_view inputPath, bool truncate)
+        {
+            // Can't simply exclude the truncate flag when !truncate. More details here: https://stackoverflow.com/a/57070159
+            if (truncate)
+                return std::ofstream::out | std::ofstream::binary | std::ofstream::trunc; // Clears existing contents of the file
+
+            // If not truncating and the file doesn't exist, then opening will fail. So we create the file first if it doesn't exist
+            if (!std::filesystem::exists(inputPath))
+            {
+                std::fstream f;
+                f.open(std::string(inputPath), std::fstream::out);
+                f.close();
+            }
+            return std::ofstream::in | std::ofstream::out | std::ofstream::binary;
+        }
+
+        std::ostream *stream_ = nullptr;
+        MemoryBuffer *buffer_ = nullptr;
+    };
+
+    // Writes to a fixed size memory buffer. Writes past the end of the buffer are truncated.
+    // Length() is the furthest position written so far rather than the size of the buffer
+    class MemorySink
+    {
+    public:
+        MemorySink(char *buffer, size_t sizeInBytes)
+            : MemorySink(reinterpret_cast<uint8_t *>(buffer), sizeInBytes)
+        {
+        }
+
+        MemorySink(uint8_t *buffer, size_t length)
+            : begin_(buffer), capacity_(length)
+        {
+        }
+
+        void Reset(char *buffer, size_t sizeInBytes)
+        {
+            Reset(reinterpret_cast<uint8_t *>(buffer), sizeInBytes);
+        }
+
+        void Reset(uint8_t *buffer, size_t length)
+        {
+            begin_ = buffer;
+            capacity_ = length;
+            position_ = 0;
+            length_ = 0;
+        }
+
+        size_t Write(const void *data, size_t size)
+        {
+            const size_t count = std::min(size, capacity_ - position_);
+            if (count > 0)
+                std::memcpy(begin_ + position_, data, count);
+
+            position_ += count;
+            length_ = std::max(length_, position_);
+            return count;
+        }
+
+        bool Seek(size_t absoluteOffset)
+        {
+            if (absoluteOffset > capacity_)
+                return false;
+
+            position_ = absoluteOffset;
+            return true;
+        }
+
+        size_t Position() const
+        {
+            return position_;
+        }
+
+        size_t Length() const
+        {
+            return length_;
+        }
+
+        void Flush()
+        {
+        }
+
+        uint8_t *Data() const
+        {
+            return begin_;
+        }
+
+        size_t Capacity() const
+        {
+            return capacity_;
+        }
+
+    private:
+        uint8_t *begin_ = nullptr;
+        size_t capacity_ = 0;
+        size_t position_ = 0;
+        size_t length_ = 0;
+    };
+
+    // Writes to a growable std::vector<uint8_t>
+    class VectorSink
+    {
+    public:
+        VectorSink() = default;
+
+        explicit VectorSink(size_t reserveBytes)
+        {
+            buffer_.reserve(reserveBytes);
+        }
+
+        // Empty the buffer but keep its capacity
+        void Reset()
+        {
+            buffer_.clear();
+            position_ = 0;
+        }
+
+        size_t Write(const void *data, size_t size)
+        {
+            if (position_ + size > buffer_.size())
+                buffer_.resize(position_ + size);
+
+            if (size > 0)
+                std::memcpy(buffer_.data() + position_, data, size);
+
+            position_ += size;
+            return size;
+        }
+
+        // Seeking past the end grows the buffer with zeros
+        bool Seek(size_t absoluteOffset)
+        {
+            if (absoluteOffset > buffer_.size())
+                buffer_.resize(absoluteOffset);
+
+            position_ = absoluteOffset;
+            return true;
+        }
+
+        size_t Position() const
+        {
+            return position_;
+        }
+
+        size_t Length() const
+        {
+            return buffer_.size();
+        }
+
+        void Flush()
+        {
+        }
+
+        std::vector<uint8_t> &Buffer()
+        {
+            return buffer_;
+        }
+
+        const std::vector<uint8_t> &Buffer() const
+        {
+            return buffer_;
+        }
+
+    private:
+        std::vector<uint8_t> buffer_;
+        size_t position_ = 0;
+    };
+}
@@ -0,0 +1,122 @@
+#include <binary_tools/AsyncReader.hpp>
+#include <binary_tools/BinaryWriter.hpp>
+
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "Test.hpp"
+
+using namespace binary_tools;
+
+namespace
+{
+    constexpr size_t ChunkSize = 4096;
+
+    Task<uint64_t> SumChunk(AsyncFileReader &reader, size_t offset, size_t &inFlight, size_t &peakInFlight)
+    {
+        std::vector<uint8_t> buffer(ChunkSize);
+        inFlight++;
+        peakInFlight = std::max(peakInFlight, inFlight);
+        const size_t count = co_await reader.ReadAtAsync(offset, buffer.data(), buffer.size());
+        inFlight--;
+
+        uint64_t sum = 0;
+        for (size_t i = 0; i < count; i++)
+            sum += buffer[i];
+        co_return sum;
+    }
+
+    Task<void> SumInto(AsyncFileReader &reader, size_t offset, uint64_t &sum, size_t &inFlight, size_t &peakInFlight)
+    {
+        sum = co_await SumChunk(reader, offset, inFlight, peakInFlight);
+    }
+
+    // ReadAsync() advances the position when the read is issued
+    Task<uint64_t> ReadSequential(AsyncFileReader &reader)
+    {
+        uint32_t first = 0;
+        uint32_t second = 0;
+        reader.SeekBeg(0);
+        co_await reader.ReadAsync(&first, 4);
+        co_await reader.ReadAsync(&second, 4);
+        co_return (static_cast<uint64_t>(first) << 32) | second;
+    }
+
+    Task<size_t> ReadPastEnd(AsyncFileReader &reader)
+    {
+        std::vector<uint8_t> buffer(100);
+        co_return co_await reader.ReadAtAsync(reader.Length() - 10, buffer.data(), buffer.size());
+    }
+
+    Task<void> Throw(AsyncFileReader &reader)
+    {
+        uint8_t byte;
+        co_await reader.ReadAtAsync(0, &byte, 1);
+        throw std::runtime_error("Task failed");
+    }
+
+    void TestBackend(const std::string &path, const std::vector<uint8_t> &data, IoBackend backend)
+    {
+        IoContext context(64, backend);
+        CHECK(context.Backend() == backend);
+        AsyncFileReader reader(context, path);
+        CHECK(reader.Length() == data.size());
+
+        // Hundreds of reads in flight at once, each summing its own chunk
+        const size_t chunks = data.size() / ChunkSize;
+        std::vector<uint64_t> sums(chunks);
+        size_t inFlight = 0;
+        size_t peakInFlight = 0;
+        for (size_t i = 0; i < chunks; i++)
+            context.Spawn(SumInto(reader, i * ChunkSize, sums[i], inFlight, peakInFlight));
+        context.Run();
+        CHECK(inFlight == 0 && peakInFlight == chunks);
+        for (size_t i = 0; i < chunks; i++)
+        {
+            uint64_t expected = 0;
+            for (size_t j = 0; j < ChunkSize; j++)
+                expected += data[i * ChunkSize + j];
+            CHECK(sums[i] == expected);
+        }
+
+        uint32_t first;
+        uint32_t second;
+        std::memcpy(&first, data.data(), 4);
+        std::memcpy(&second, data.data() + 4, 4);
+        CHECK(context.Run(ReadSequential(reader)) == ((static_cast<uint64_t>(first) << 32) | second));
+        CHECK(reader.Position() == 8);
+        CHECK(context.Run(ReadPastEnd(reader)) == 10);
+
+        // Exceptions from spawned tasks come out of Run()
+        context.Spawn(Throw(reader));
+        CHECK_THROWS(context.Run(), std::runtime_error);
+    }
+}
+
+int main()
+{
+    const std::string path = tests::TempPath("async.bin");
+    {
+        BinaryWriter writer(path);
+        for (uint32_t i = 0; i < 256 * 1024; i++)
+            writer.WriteUint32(i * 2654435761u);
+    }
+    std::ifstream input(path, std::ios::binary);
+    const std::vector<uint8_t> data((std::istreambuf_iterator<char>(input)), {});
+    input.close();
+
+    // The fallback always works. io_uring is tested when the kernel or sandbox allows it
+    TestBackend(path, data, IoBackend::Synchronous);
+    if (IoContext().Backend() == IoBackend::IoUring)
+        TestBackend(path, data, IoBackend::IoUring);
+    else
+        std::printf("io_uring isn't available. Only the synchronous backend was tested\n");
+
+    IoContext context;
+    CHECK_THROWS((void)AsyncFileReader(context, tests::TempPath("missing.bin")), std::runtime_error);
+    std::filesystem::remove(path);
+    return 0;
+}
@@ -0,0 +1,264 @@
+#include <binary_tools/AttributeFormats.hpp>
+#include <binary_tools/BinaryReader.hpp>
+#include <binary_tools/BinaryStreamReader.hpp>
+#include <binary_tools/BinaryWriter.hpp>
+#include <binary_tools/CheckedBinaryReader.hpp>
+
+#include <cmath>
+#include <limits>
+#include <random>
+#include <sstream>
+#include <vector>
+
+#include "Test.hpp"
+
+using namespace binary_tools;
+
+namespace
+{
+    constexpr AttributeFormat ValueFormats[] = {AttributeFormat::Float32, AttributeFormat::Float16, AttributeFormat::Snorm8,
+                                                AttributeFormat::Unorm8, AttributeFormat::Snorm16, AttributeFormat::Unorm16};
+    constexpr AttributeFormat PackedFormats[] = {AttributeFormat::Snorm10_10_10_2, AttributeFormat::Unorm10_10_10_2};
+
+    uint32_t Bits(float value)
+    {
+        uint32_t bits;
+        std::memcpy(&bits, &value, 4);
+        return bits;
+    }
+
+    // Same bits, so NaNs must also match in sign, payload and quiet bit
+    bool SameFloat(float a, float b)
+    {
+        return Bits(a) == Bits(b);
+    }
+
+    // Independent of HalfToFloat(). Finite values only
+    float ReferenceHalfToFloat(uint16_t half)
+    {
+        const int exponent = (half >> 10) & 0x1F;
+        const int mantissa = half & 0x3FF;
+        const float magnitude = exponent == 0 ? std::ldexp(static_cast<float>(mantissa), -24)
+                                              : std::ldexp(static_cast<float>(mantissa + 1024), exponent - 25);
+        return (half & 0x8000) ? -magnitude : magnitude;
+    }
+
+    // Every half converts exactly, and the SIMD bulk path matches the scalar conversion bit for bit
+    void TestEveryHalf()
+    {
+        std::vector<uint16_t> halves(65536);
+        for (uint32_t i = 0; i < 65536; i++)
+            halves[i] = static_cast<uint16_t>(i);
+
+        std::vector<float> bulk(65536);
+        DecodeAttribute(halves.data(), 0, AttributeFormat::Float16, 1, halves.size(), bulk.data());
+        std::vector<uint16_t> encoded(65536);
+        EncodeAttribute(bulk.data(), 0, AttributeFormat::Float16, 1, bulk.size(), encoded.data());
+
+        for (uint32_t i = 0; i < 65536; i++)
+        {
+            const uint16_t half = static_cast<uint16_t>(i);
+            const float value = HalfToFloat(half);
+            CHECK(SameFloat(bulk[i], value));
+
+            // NaNs keep their payload and come back quiet
+            const bool isNaN = (half & 0x7C00) == 0x7C00 && (half & 0x3FF) != 0;
+            const uint16_t expected = isNaN ? half | 0x200 : half;
+            if ((half & 0x7C00) != 0x7C00)
+                CHECK(value == ReferenceHalfToFloat(half));
+            CHECK(std::isnan(value) == isNaN);
+            CHECK(FloatToHalf(value) == expected);
+            CHECK(encoded[i] == expected);
+        }
+    }
+
+    // Rounding to nearest even, overflow and underflow. The bulk encoder must agree with FloatToHalf()
+    void TestFloatToHalf()
+    {
+        CHECK(FloatToHalf(65504.0f) == 0x7BFF);
+        CHECK(FloatToHalf(65520.0f) == 0x7C00); // Halfway to the next power of two rounds to infinity
+        CHECK(FloatToHalf(-1e10f) == 0xFC00);
+        CHECK(FloatToHalf(1.0f + 1.0f / 2048.0f) == 0x3C00); // Tie, rounds to even
+        CHECK(FloatToHalf(1.0f + 3.0f / 2048.0f) == 0x3C02);
+        CHECK(FloatToHalf(std::ldexp(1.0f, -25)) == 0x0000); // Tie with the smallest subnormal, rounds to even
+        CHECK(FloatToHalf(std::ldexp(1.5f, -25)) == 0x0001);
+        CHECK(FloatToHalf(-0.0f) == 0x8000);
+        CHECK(FloatToHalf(std::numeric_limits<float>::quiet_NaN()) == 0x7E00);
+
+        std::mt19937 random(36);
+        std::vector<float> values(100003);
+        for (float &value : values)
+        {
+            const uint32_t bits = random();
+            std::memcpy(&value, &bits, 4);
+        }
+        values[0] = std::numeric_limits<float>::infinity();
+        values[1] = std::numeric_limits<float>::denorm_min();
+
+        std::vector<uint16_t> encoded(values.size());
+        EncodeAttribute(values.data(), 0, AttributeFormat::Float16, 1, values.size(), encoded.data());
+        for (size_t i = 0; i < values.size(); i++)
+            CHECK(encoded[i] == FloatToHalf(values[i]));
+    }
+
+    // DecodeAttribute() and EncodeAttribute() against the per value scalar helpers for every format, component count,
+    // stride and byte order
+    void TestBulkMatchesScalar()
+    {
+        std::mt19937 random(360);
+        for (size_t iteration = 0; iteration < 400; iteration++)
+        {
+            const bool swap = random() % 2 == 0;
+            const size_t count = random() % 70;
+            for (AttributeFormat format : ValueFormats)
+            {
+                for (size_t components = 1; components <= 4; components++)
+                {
+                    const size_t elementSize = AttributeSize(format, components);
+                    const size_t sourceStride = elementSize + (random() % 2) * (random() % 9);
+                    const size_t destinationStride = components + random() % 2;
+
+                    std::vector<uint8_t> source(count * sourceStride + 1);
+                    for (uint8_t &byte : source)
+                        byte = static_cast<uint8_t>(random());
+
+                    std::vector<float> decoded(count * destinationStride + 1, -7.0f);
+                    DecodeAttribute(source.data(), sourceStride, format, components, count, decoded.data(), destinationStride, swap);
+                    for (size_t i = 0; i < count; i++)
+                    {
+                        float expected[4];
+                        DecodeValues(source.data() + i * sourceStride, format, components, expected, swap);
+                        for (size_t c = 0; c < components; c++)
+                            CHECK(SameFloat(decoded[i * destinationStride + c], expected[c]));
+                        for (size_t c = components; c < destinationStride; c++)
+                            CHECK(decoded[i * destinationStride + c] == -7.0f); // Gaps are left alone
+                    }
+
+                    // Re-encode the decoded values, which are all representable, plus some out of range ones
+                    for (size_t i = 0; i < count && format != AttributeFormat::Float32 && format != AttributeFormat::Float16; i += 7)
+                        decoded[i * destinationStride] = (random() % 2) ? 5.0f : -5.0f;
+
+                    std::vector<uint8_t> encoded(count * elementSize + 1, 0xCC);
+                    EncodeAttribute(decoded.data(), destinationStride, format, components, count, encoded.data(), 0, swap);
+                    for (size_t i = 0; i < count; i++)
+                    {
+                        uint8_t expected[16];
+                        EncodeValues(decoded.data() + i * destinationStride, format, components, expected, swap);
+                        CHECK(std::memcmp(encoded.data() + i * elementSize, expected, elementSize) == 0);
+                    }
+                    CHECK(encoded.back() == 0xCC);
+                }
+            }
+
+            // Packed formats against DecodePacked() and EncodePacked()
+            for (AttributeFormat format : PackedFormats)
+            {
+                const bool isSigned = format == AttributeFormat::Snorm10_10_10_2;
+                for (size_t components = 1; components <= 4; components++)
+                {
+                    std::vector<uint32_t> words(count);
+                    for (uint32_t &word : words)
+                        word = random();
+
+                    std::vector<float> decoded(count * 4, -7.0f);
+                    DecodeAttribute(words.data(), 4, format, components, count, decoded.data(), 4, swap);
+                    std::vector<uint32_t> encoded(count);
+                    EncodeAttribute(decoded.data(), 4, format, components, count, encoded.data(), 4, swap);
+                    for (size_t i = 0; i < count; i++)
+                    {
+                        float expected[4];
+                        DecodePacked(swap ? ByteSwap32(words[i]) : words[i], isSigned, expected);
+                        for (size_t c = 0; c < components; c++)
+                            CHECK(SameFloat(decoded[i * 4 + c], expected[c]));
+
+                        float values[4] = {};
+                        std::memcpy(values, decoded.data() + i * 4, components * sizeof(float));
+                        const uint32_t word = EncodePacked(values, isSigned);
+                        CHECK(encoded[i] == (swap ? ByteSwap32(word) : word));
+                    }
+                }
+            }
+        }
+    }
+
+    // Interleaved vertices through the reader and writer on every kind of source
+    void TestReaderWriter()
+    {
+        struct Vertex
+        {
+            float Position[3];
+            float Normal[3];
+        };
+        std::vector<Vertex> vertices(1000);
+        for (size_t i = 0; i < vertices.size(); i++)
+        {
+            for (size_t c = 0; c < 3; c++)
+            {
+                vertices[i].Position[c] = static_cast<float>(i) * 0.25f + static_cast<float>(c);
+                vertices[i].Normal[c] = static_cast<float>((i + c) % 5) * 0.25f - 0.5f;
+            }
+        }
+
+        BasicBinaryWriter<VectorSink, BigEndian> writer;
+        writer.WriteUint8(1); // Misalign the attributes
+        writer.WriteAttribute(AttributeFormat::Float16, 3, vertices.size(), &vertices[0].Position[0], 6);
+        writer.WriteAttribute(AttributeFormat::Snorm10_10_10_2, 3, vertices.size(), &vertices[0].Normal[0], 6);
+        const std::vector<uint8_t> &buffer = writer.GetSink().Buffer();
+        CHECK(buffer.size() == 1 + vertices.size() * (6 + 4));
+
+        auto check = [&](auto &reader)
+        {
+            std::vector<Vertex> output(vertices.size());
+            reader.Skip(1);
+            CHECK(reader.ReadAttribute(AttributeFormat::Float16, 3, output.size(), &output[0].Position[0], 0, 6));
+            CHECK(reader.ReadAttribute(AttributeFormat::Snorm10_10_10_2, 3, output.size(), &output[0].Normal[0], 0, 6));
+            CHECK(reader.EndOfStream());
+            for (size_t i = 0; i < output.size(); i++)
+            {
+                for (size_t c = 0; c < 3; c++)
+                {
+                    CHECK(output[i].Position[c] == HalfToFloat(FloatToHalf(vertices[i].Position[c])));
+                    CHECK(std::fabs(output[i].Normal[c] - vertices[i].Normal[c]) <= 0.5f / 511.0f);
+                }
+            }
+        };
+        BasicBinaryReader<MemorySource, BigEndian> memoryReader(buffer.data(), buffer.size());
+        check(memoryReader);
+        std::istringstream stream(std::string(buffer.begin(), buffer.end()));
+        BasicBinaryReader<RingBufferSource, BigEndian> streamReader(stream, 256);
+        check(streamReader);
+    }
+
+    void TestInvalidArguments()
+    {
+        std::vector<uint8_t> data(64, 0x3C);
+        std::vector<float> output(64, 1.0f);
+
+        // Strides smaller than an element are rejected without reading
+        MemoryBinaryReader reader(data.data(), data.size());
+        CHECK(!reader.ReadAttribute(AttributeFormat::Float16, 3, 4, output.data(), 2));
+        CHECK(reader.Position() == 0 && output[0] == 0.0f);
+
+        // Short data zeroes the destination and consumes what's left
+        CHECK(!reader.ReadAttribute(AttributeFormat::Float32, 4, 5, output.data()));
+        CHECK(reader.EndOfStream() && output[19] == 0.0f);
+
+        // Bad component counts throw on unchecked readers and fail checked ones
+        MemoryBinaryReader unchecked(data.data(), data.size());
+        CHECK_THROWS(unchecked.ReadAttribute(AttributeFormat::Float16, 5, 1, output.data()), std::invalid_argument);
+        CheckedBinaryReader checked(data.data(), data.size());
+        CHECK(!checked.ReadAttribute(AttributeFormat::Float16, 0, 1, output.data()));
+        CHECK(checked.HasError());
+        CHECK_THROWS(AttributeSize(AttributeFormat::Float32, 5), std::invalid_argument);
+    }
+}
+
+int main()
+{
+    TestEveryHalf();
+    TestFloatToHalf();
+    TestBulkMatchesScalar();
+    TestReaderWriter();
+    TestInvalidArguments();
+    return 0;
+}
@@ -0,0 +1,178 @@
+#include <binary_tools/BinaryReader.hpp>
+#include <binary_tools/BinaryStreamReader.hpp>
+#include <binary_tools/BinaryWriter.hpp>
+
+#include <sstream>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "Test.hpp"
+
+using namespace binary_tools;
+
+// Single arguments shouldn't silently turn into readers and writers
+static_assert(!std::is_convertible<std::string_view, BinaryReader>::value);
+static_assert(!std::is_convertible<std::string_view, BinaryWriter>::value);
+
+namespace
+{
+    struct Header
+    {
+        uint32_t Signature;
+        uint16_t Version;
+        uint16_t Flags;
+    };
+
+    template <typename Writer>
+    void WriteSample(Writer &writer)
+    {
+        writer.WriteUint8(0xAB);
+        writer.WriteUint16(0x1234);
+        writer.WriteUint32(0x89ABCDEF);
+        writer.WriteUint64(0x0123456789ABCDEFull);
+        writer.WriteInt32(-123456);
+        writer.WriteBoolean(true);
+        writer.WriteFloat(1.5f);
+        writer.WriteDouble(-0.25);
+        writer.WriteHalf(0.5f);
+        writer.WriteNullTerminatedString("null terminated");
+        writer.WriteFixedLengthString("fixed");
+        writer.WriteNullTerminatedUtf16String(u"utf16");
+        writer.Align(16);
+        writer.Write(Header{0x46464646, 3, 7});
+    }
+
+    template <typename Reader>
+    void ReadSample(Reader &reader)
+    {
+        CHECK(reader.ReadUint8() == 0xAB);
+        CHECK(reader.ReadUint16() == 0x1234);
+        CHECK(reader.ReadUint32() == 0x89ABCDEF);
+        CHECK(reader.ReadUint64() == 0x0123456789ABCDEFull);
+        CHECK(reader.ReadInt32() == -123456);
+        CHECK(reader.ReadBoolean());
+        CHECK(reader.ReadFloat() == 1.5f);
+        CHECK(reader.ReadDouble() == -0.25);
+        CHECK(reader.ReadHalf() == 0.5f);
+        CHECK(reader.ReadNullTerminatedString() == "null terminated");
+        CHECK(reader.ReadFixedLengthString(5) == "fixed");
+        CHECK(reader.ReadNullTerminatedUtf16String() == u"utf16");
+        reader.Align(16);
+        CHECK(reader.Position() % 16 == 0);
+        const Header header = reader.template Read<Header>();
+        CHECK(header.Signature == 0x46464646 && header.Version == 3 && header.Flags == 7);
+        CHECK(reader.EndOfStream());
+    }
+
+    // Every source reads the same data
+    template <typename Endian>
+    void TestRoundTrip()
+    {
+        BasicBinaryWriter<VectorSink, Endian> writer;
+        WriteSample(writer);
+        std::vector<uint8_t> &buffer = writer.GetSink().Buffer();
+        CHECK(writer.Length() == buffer.size());
+
+        BasicBinaryReader<MemorySource, Endian> memoryReader(buffer.data(), buffer.size());
+        ReadSample(memoryReader);
+
+        BasicBinaryReader<StreamSource, Endian> streamReader(buffer.data(), buffer.size());
+        ReadSample(streamReader);
+
+        std::istringstream stream(std::string(buffer.begin(), buffer.end()));
+        BasicBinaryReader<RingBufferSource, Endian> ringReader(stream, 64);
+        ReadSample(ringReader);
+
+        const std::string path = tests::TempPath("round_trip.bin");
+        {
+            BasicBinaryWriter<StreamSink, Endian> fileWriter(path);
+            WriteSample(fileWriter);
+        }
+        {
+            BasicBinaryReader<MappedFileSource, Endian> mappedReader(path);
+            CHECK(mappedReader.Length() == buffer.size());
+            ReadSample(mappedReader);
+
+            BasicBinaryReader<StreamSource, Endian> fileReader(path);
+            ReadSample(fileReader);
+        }
+        std::remove(path.c_str());
+    }
+
+    void TestByteOrder()
+    {
+        BasicBinaryWriter<VectorSink, BigEndian> big;
+        big.WriteUint32(0x01020304);
+        big.WriteUint16(0x0506);
+        const std::vector<uint8_t> expected = {1, 2, 3, 4, 5, 6};
+        CHECK(big.GetSink().Buffer() == expected);
+
+        BasicBinaryWriter<VectorSink, LittleEndian> little;
+        little.WriteUint32(0x01020304);
+        const std::vector<uint8_t> expectedLittle = {4, 3, 2, 1};
+        CHECK(little.GetSink().Buffer() == expectedLittle);
+
+        // Reading with the other byte order swaps
+        BasicBinaryReader<MemorySource, LittleEndian> reader(expected.data(), expected.size());
+        CHECK(reader.ReadUint32() == 0x04030201);
+    }
+
+    void TestSeeking()
+    {
+        uint8_t data[64];
+        for (uint8_t i = 0; i < sizeof(data); i++)
+            data[i] = i;
+
+        MemoryBinaryReader reader(data, sizeof(data));
+        reader.SeekBeg(10);
+        CHECK(reader.PeekChar() == 10);
+        reader.SeekCur(5);
+        CHECK(reader.Position() == 15);
+        reader.SeekReverse(100);
+        CHECK(reader.Position() == 0);
+        reader.SeekEnd(4);
+        CHECK(reader.ReadUint8() == 60);
+        CHECK(reader.Skip(10) == 3);
+        CHECK(reader.EndOfStream());
+
+        // Short values are consumed so EndOfStream() is reached
+        MemoryBinaryReader shortReader(data, 3);
+        CHECK(shortReader.ReadUint32() == 0);
+        CHECK(shortReader.EndOfStream());
+
+        // Writers pad with zeros when seeking past the end
+        uint8_t output[16] = {};
+        MemoryBinaryWriter writer(output, sizeof(output));
+        writer.SeekBeg(4);
+        writer.WriteUint8(9);
+        writer.SeekBeg(0);
+        writer.WriteUint8(1);
+        CHECK(output[0] == 1 && output[4] == 9);
+    }
+
+    void TestReset()
+    {
+        const uint8_t first[] = {1, 2};
+        const uint8_t second[] = {3};
+        MemoryBinaryReader reader(first, sizeof(first));
+        CHECK(reader.ReadUint8() == 1);
+        reader.Reset(second, sizeof(second));
+        CHECK(reader.Position() == 0 && reader.ReadUint8() == 3);
+
+        VectorBinaryWriter writer;
+        writer.WriteUint32(5);
+        writer.Reset();
+        CHECK(writer.Length() == 0);
+    }
+}
+
+int main()
+{
+    TestRoundTrip<LittleEndian>();
+    TestRoundTrip<BigEndian>();
+    TestByteOrder();
+    TestSeeking();
+    TestReset();
+    return 0;
+}
@@ -0,0 +1,173 @@
+#include <binary_tools/BinaryStreamReader.hpp>
+#include <binary_tools/BinaryWriter.hpp>
+
+#include <chrono>
+#include <sstream>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+#if !defined(_WIN32)
+#include <csignal>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+#include "Test.hpp"
+
+using namespace binary_tools;
+
+namespace
+{
+    std::string WriteRecords(size_t count)
+    {
+        VectorBinaryWriter writer;
+        for (uint32_t i = 0; i < count; i++)
+        {
+            writer.WriteUint32(i);
+            writer.WriteNullTerminatedString("record" + std::to_string(i));
+            writer.WriteFloat(static_cast<float>(i) * 0.5f);
+        }
+        const std::vector<uint8_t> &buffer = writer.GetSink().Buffer();
+        return std::string(buffer.begin(), buffer.end());
+    }
+
+    // Small capacities force strings and values to straddle the ring buffer's wrap point
+    void TestRoundTrip()
+    {
+        const std::string data = WriteRecords(2000);
+        for (size_t capacity : {size_t(1), size_t(300), RingBufferSource::DefaultCapacity})
+        {
+            std::istringstream stream(data);
+            BinaryStreamReader reader(stream, capacity);
+            for (uint32_t i = 0; i < 2000; i++)
+            {
+                CHECK(reader.PeekUint32() == i);
+                CHECK(reader.ReadUint32() == i);
+                CHECK(reader.ReadNullTerminatedString() == "record" + std::to_string(i));
+                CHECK(reader.ReadFloat() == static_cast<float>(i) * 0.5f);
+            }
+            CHECK(reader.EndOfStream());
+            CHECK(reader.Position() == data.size());
+        }
+    }
+
+    void TestLargeReadsAndSkips()
+    {
+        std::string data(100000, '\0');
+        for (size_t i = 0; i < data.size(); i++)
+            data[i] = static_cast<char>(i * 7);
+
+        std::istringstream stream(data);
+        BinaryStreamReader reader(stream, 256);
+        std::vector<char> output(data.size());
+        CHECK(reader.ReadToMemory(output.data(), 3) == 3);
+        CHECK(reader.Skip(1000) == 1000);
+        CHECK(reader.ReadToMemory(output.data() + 1003, 50000) == 50000); // Bypasses the ring buffer
+        CHECK(std::equal(output.begin() + 1003, output.begin() + 51003, data.begin() + 1003));
+        reader.Align(16);
+        CHECK(reader.Position() == 51008);
+
+        // Short reads report what was read and zero the rest
+        CHECK(reader.Skip(data.size()) == data.size() - 51008);
+        uint32_t value = 0xFFFFFFFF;
+        CHECK(reader.ReadToMemory(&value, 4) == 0 && value == 0);
+        CHECK(reader.EndOfStream());
+    }
+
+    void TestLengthHint()
+    {
+        const std::string data = WriteRecords(10);
+        std::istringstream stream(data);
+        BinaryStreamReader reader(stream, 256, data.size());
+        CHECK(reader.Length() == data.size());
+    }
+
+    void TestSizedStringList()
+    {
+        VectorBinaryWriter writer;
+        writer.WriteNullTerminatedString("first");
+        writer.WriteUint8(0); // Extra null padding
+        writer.WriteUint8(0);
+        writer.WriteNullTerminatedString("second");
+        writer.WriteUint32(0xABCD);
+        const std::vector<uint8_t> &buffer = writer.GetSink().Buffer();
+
+        std::istringstream stream(std::string(buffer.begin(), buffer.end()));
+        BinaryStreamReader reader(stream, 256);
+        const std::vector<std::string> list = reader.ReadSizedStringList(buffer.size() - 4);
+        CHECK(list.size() == 2 && list[0] == "first" && list[1] == "second");
+        CHECK(reader.ReadUint32() == 0xABCD);
+    }
+
+#if !defined(_WIN32)
+    // Reads a pipe with ::read() so data arrives in the pieces the writer sent
+    class PipeBuffer : public std::streambuf
+    {
+    public:
+        explicit PipeBuffer(int file) : file_(file) {}
+
+    protected:
+        int_type underflow() override
+        {
+            const ssize_t count = ::read(file_, buffer_, sizeof(buffer_));
+            if (count <= 0)
+                return traits_type::eof();
+
+            setg(buffer_, buffer_, buffer_ + count);
+            return traits_type::to_int_type(buffer_[0]);
+        }
+
+    private:
+        int file_;
+        char buffer_[4096];
+    };
+
+    // Strings that are already buffered must be returned without waiting for a full chunk or EOF
+    void TestPipeDoesNotBlock()
+    {
+        int pipeFiles[2];
+        CHECK(::pipe(pipeFiles) == 0);
+        const pid_t child = ::fork();
+        CHECK(child >= 0);
+        if (child == 0)
+        {
+            ::close(pipeFiles[0]);
+            const char message[] = "\x07\x00\x00\x00hello\0list\0\0\0h\0i\0\0\0";
+            if (::write(pipeFiles[1], message, sizeof(message) - 1) < 0)
+                ::_exit(1);
+            ::sleep(3); // Keep the pipe open so EOF doesn't arrive until well after the reads should be done
+            ::_exit(0);
+        }
+        ::close(pipeFiles[1]);
+
+        PipeBuffer pipeBuffer(pipeFiles[0]);
+        std::istream stream(&pipeBuffer);
+        BinaryStreamReader reader(stream);
+        const auto start = std::chrono::steady_clock::now();
+        CHECK(reader.ReadUint32() == 7);
+        CHECK(reader.ReadNullTerminatedString() == "hello");
+        const std::vector<std::string> list = reader.ReadSizedStringList(7);
+        CHECK(list.size() == 1 && list[0] == "list");
+        CHECK(reader.ReadNullTerminatedUtf16StringAsUtf8() == "hi");
+        const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        CHECK(seconds < 1.5);
+
+        ::kill(child, SIGKILL);
+        ::waitpid(child, nullptr, 0);
+        ::close(pipeFiles[0]);
+    }
+#endif
+}
+
+int main()
+{
+    TestRoundTrip();
+    TestLargeReadsAndSkips();
+    TestLengthHint();
+    TestSizedStringList();
+#if !defined(_WIN32)
+    TestPipeDoesNotBlock();
+#endif
+    return 0;
+}
@@ -0,0 +1,99 @@
+#include <binary_tools/BinaryReader.hpp>
+#include <binary_tools/BinaryWriter.hpp>
+#include <binary_tools/CheckedBinaryReader.hpp>
+
+#include <vector>
+
+#include "Test.hpp"
+
+using namespace binary_tools;
+
+namespace
+{
+    void TestRoundTrip()
+    {
+        VectorBinaryWriter writer;
+        writer.WriteUint32(0xDEADBEEF);
+        writer.WriteInt16(-5);
+        writer.WriteNullTerminatedString("name");
+        writer.WriteFixedLengthString("abc");
+        writer.WriteDouble(2.5);
+        const std::vector<uint8_t> &buffer = writer.GetSink().Buffer();
+
+        CheckedBinaryReader reader(buffer.data(), buffer.size());
+        CHECK(reader.Ensure(6));
+        CHECK(reader.ReadUnchecked<uint32_t>() == 0xDEADBEEF);
+        CHECK(reader.ReadUnchecked<int16_t>() == -5);
+        CHECK(reader.TryReadNullTerminatedString() == std::optional<std::string>("name"));
+        CHECK(reader.TryReadFixedLengthString(3) == std::optional<std::string>("abc"));
+        CHECK(reader.TryRead<double>() == std::optional<double>(2.5));
+        CHECK(reader.EndOfStream() && !reader.HasError());
+    }
+
+    // Every read after the first failure fails and returns zero or empty values
+    void TestStickyError()
+    {
+        const uint8_t data[] = {1, 2, 3, 4, 5, 'a', 'b'};
+        CheckedBinaryReader reader(data, sizeof(data));
+        CHECK(reader.ReadUint32() == 0x04030201);
+        CHECK(!reader.TryRead<uint32_t>());
+        CHECK(reader.HasError() && reader.EndOfStream());
+
+        CHECK(reader.ReadUint8() == 0);
+        reader.SeekBeg(0);
+        CHECK(reader.HasError());
+        CHECK(reader.ReadUint8() == 0);
+        CHECK(reader.Skip(1) == 0);
+
+        // Reset() points the reader at new data and clears the error
+        reader.Reset(data, sizeof(data));
+        CHECK(!reader.HasError());
+        CHECK(reader.ReadUint8() == 1);
+    }
+
+    void TestStrings()
+    {
+        const char unterminated[] = {'a', 'b', 'c'};
+        {
+            CheckedBinaryReader reader(reinterpret_cast<const uint8_t *>(unterminated), sizeof(unterminated));
+            CHECK(!reader.TryReadNullTerminatedString());
+            CHECK(reader.HasError());
+        }
+        {
+            CheckedBinaryReader reader(reinterpret_cast<const uint8_t *>(unterminated), sizeof(unterminated));
+            CHECK(!reader.TryReadFixedLengthString(4));
+            CHECK(reader.ReadFixedLengthString(1).empty());
+        }
+        {
+            CheckedBinaryReader reader(reinterpret_cast<const uint8_t *>(unterminated), sizeof(unterminated));
+            CHECK(!reader.Ensure(4));
+            CHECK(reader.HasError());
+        }
+    }
+
+    // Short reads zero the destination and report how much was actually read
+    void TestShortReads()
+    {
+        const uint8_t data[] = {9, 8, 7};
+        CheckedBinaryReader reader(data, sizeof(data));
+        uint8_t output[5] = {1, 1, 1, 1, 1};
+        CHECK(reader.ReadToMemory(output, sizeof(output)) == 3);
+        CHECK(output[0] == 9 && output[2] == 7 && output[3] == 0 && output[4] == 0);
+        CHECK(reader.HasError());
+        CHECK(reader.ReadToMemory(output, 1) == 0 && output[0] == 0);
+
+        MemoryBinaryReader unchecked(data, sizeof(data));
+        CHECK(unchecked.ReadToMemory(output, sizeof(output)) == 3);
+        CHECK(output[0] == 9 && output[2] == 7 && output[3] == 0);
+        CHECK(!unchecked.HasError() && unchecked.EndOfStream());
+    }
+}
+
+int main()
+{
+    TestRoundTrip();
+    TestStickyError();
+    TestStrings();
+    TestShortReads();
+    return 0;
+}
@@ -0,0 +1,160 @@
+#include <binary_tools/DeltaBinaryWriter.hpp>
+
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <string>
+#include <vector>
+
+#if !defined(_WIN32)
+#include <csignal>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+#include "Test.hpp"
+
+using namespace binary_tools;
+
+namespace
+{
+    constexpr size_t BlockSize = 4096;
+
+    std::vector<uint8_t> ReadFile(const std::string &path)
+    {
+        std::ifstream input(path, std::ios::binary);
+        return std::vector<uint8_t>(std::istreambuf_iterator<char>(input), {});
+    }
+
+    void WriteFile(const std::string &path, const std::vector<uint8_t> &data)
+    {
+        std::ofstream output(path, std::ios::binary | std::ios::trunc);
+        output.write(reinterpret_cast<const char *>(data.data()), static_cast<std::streamsize>(data.size()));
+    }
+
+    // Rewrite the whole file with data and return the bytes that hit the disk.
+    // Each write that differs is staged whole, so writing a byte at a time makes the dirty ranges exact
+    uint64_t Rewrite(const std::string &path, const std::vector<uint8_t> &data)
+    {
+        DeltaBinaryWriter writer(path, BlockSize);
+        for (uint8_t byte : data)
+            writer.WriteUint8(byte);
+        writer.Flush();
+        return writer.GetSink().BytesWritten();
+    }
+
+    void TestDirtyRanges(const std::string &path)
+    {
+        std::mt19937 random(32);
+        std::vector<uint8_t> data(BlockSize * 10 + 123);
+        for (uint8_t &byte : data)
+            byte = static_cast<uint8_t>(random());
+        WriteFile(path, data);
+
+        // Identical data writes nothing
+        CHECK(Rewrite(path, data) == 0);
+        CHECK(ReadFile(path) == data);
+
+        // One dirty range per block, from the first to the last changed byte
+        data[BlockSize * 3 + 10] ^= 1;
+        data[BlockSize * 3 + 20] ^= 1;
+        data[BlockSize * 7] ^= 1;
+        data.back() ^= 1;
+        CHECK(Rewrite(path, data) == 11 + 1 + 1);
+        CHECK(ReadFile(path) == data);
+
+        // Growing the file writes the new bytes
+        data.resize(data.size() + BlockSize + 5, 0x42);
+        CHECK(Rewrite(path, data) == BlockSize + 5);
+        CHECK(ReadFile(path) == data);
+
+        // Zeros past the end still count as new data
+        data.resize(data.size() + 10, 0);
+        CHECK(Rewrite(path, data) == 10);
+        CHECK(ReadFile(path) == data);
+    }
+
+    // Patching an earlier block after moving on, e.g. filling in a header once the size is known
+    void TestSeekBack(const std::string &path)
+    {
+        std::vector<uint8_t> data(BlockSize * 4, 7);
+        WriteFile(path, data);
+        {
+            DeltaBinaryWriter writer(path, BlockSize);
+            writer.SeekBeg(BlockSize * 3 + 1);
+            writer.WriteUint8(1);
+            writer.SeekBeg(4);
+            writer.WriteUint32(0x01020304);
+            writer.SeekBeg(BlockSize * 3 + 2);
+            writer.WriteUint8(2);
+            writer.Flush();
+            CHECK(writer.GetSink().BytesWritten() == 6);
+        }
+        data[BlockSize * 3 + 1] = 1;
+        data[BlockSize * 3 + 2] = 2;
+        const uint32_t value = 0x01020304;
+        std::memcpy(data.data() + 4, &value, 4);
+        CHECK(ReadFile(path) == data);
+    }
+
+    void TestTruncateAndNewFiles(const std::string &path)
+    {
+        std::vector<uint8_t> data(BlockSize * 2, 9);
+        WriteFile(path, data);
+        {
+            DeltaBinaryWriter writer(path, BlockSize);
+            writer.WriteFromMemory(data.data(), 100);
+            writer.GetSink().Truncate(100);
+            CHECK(writer.GetSink().BytesWritten() == 0);
+        }
+        CHECK(std::filesystem::file_size(path) == 100);
+
+        // New files are created and everything is written
+        std::filesystem::remove(path);
+        CHECK(Rewrite(path, data) == data.size());
+        CHECK(ReadFile(path) == data);
+    }
+
+#if !defined(_WIN32)
+    // Write errors are reported by Flush() and the range stays dirty. Runs in a child since the file size limit is per process
+    void TestFlushErrors(const std::string &path)
+    {
+        WriteFile(path, std::vector<uint8_t>(1000, 1));
+        const pid_t child = ::fork();
+        CHECK(child >= 0);
+        if (child == 0)
+        {
+            std::signal(SIGXFSZ, SIG_IGN);
+            const rlimit limit = {4096, 4096};
+            ::setrlimit(RLIMIT_FSIZE, &limit);
+
+            DeltaBinaryWriter writer(path, BlockSize);
+            writer.SeekBeg(BlockSize * 2);
+            writer.WriteUint32(1);
+            CHECK_THROWS(writer.Flush(), std::runtime_error);
+            CHECK_THROWS(writer.Flush(), std::runtime_error);
+            CHECK(writer.GetSink().BytesWritten() == 0);
+            std::_Exit(0);
+        }
+
+        int status = 0;
+        CHECK(::waitpid(child, &status, 0) == child);
+        CHECK(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+    }
+#endif
+}
+
+int main()
+{
+    const std::string path = tests::TempPath("delta.bin");
+    TestDirtyRanges(path);
+    TestSeekBack(path);
+    TestTruncateAndNewFiles(path);
+#if !defined(_WIN32)
+    TestFlushErrors(path);
+#endif
+    std::filesystem::remove(path);
+    return 0;
+}
@@ -0,0 +1,134 @@
+#include <binary_tools/DirectBinaryWriter.hpp>
+
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <string>
+#include <vector>
+
+#if !defined(_WIN32)
+#include <sys/stat.h>
+#endif
+
+#include "Test.hpp"
+
+using namespace binary_tools;
+
+namespace
+{
+    std::vector<uint8_t> ReadFile(const std::string &path)
+    {
+        std::ifstream input(path, std::ios::binary);
+        return std::vector<uint8_t>(std::istreambuf_iterator<char>(input), {});
+    }
+
+    // Random appends, small gaps and patches of earlier data, mirrored into a plain vector
+    void TestMatchesModel(const std::string &path, bool dropCache)
+    {
+        std::mt19937 random(35);
+        std::vector<uint8_t> model;
+        {
+            DirectBinaryWriter writer(path, 3 * DirectFileSink::Alignment, dropCache);
+            CHECK(writer.GetSink().BufferSize() == 3 * DirectFileSink::Alignment);
+            for (size_t operation = 0; operation < 800; operation++)
+            {
+                const uint32_t kind = random() % 10;
+                if (kind == 0)
+                    writer.SeekBeg(writer.Length() + random() % 20000); // Gap of zeros, sometimes past the buffer
+                else if (kind == 1)
+                    writer.SeekBeg(random() % (writer.Length() + 1)); // Patch earlier data, often already on disk
+                else if (kind == 2)
+                    writer.SeekBeg(writer.Length());
+
+                std::vector<uint8_t> data(1 + random() % 3000);
+                for (uint8_t &byte : data)
+                    byte = static_cast<uint8_t>(random());
+
+                const size_t position = writer.Position();
+                writer.WriteFromMemory(data.data(), data.size());
+                if (model.size() < position + data.size())
+                    model.resize(position + data.size());
+                std::copy(data.begin(), data.end(), model.begin() + position);
+                CHECK(writer.Length() == model.size());
+
+                // Flushing writes the padded tail, then truncates it to the real length
+                if (operation % 200 == 0)
+                {
+                    writer.Flush();
+                    CHECK(std::filesystem::file_size(path) == model.size());
+                    CHECK(ReadFile(path) == model);
+                }
+            }
+        }
+        CHECK(ReadFile(path) == model);
+    }
+
+    // The unaligned tail is padded for the direct write and cut off again
+    void TestTailTruncation(const std::string &path)
+    {
+        for (size_t size : {size_t(0), size_t(1), DirectFileSink::Alignment - 1, DirectFileSink::Alignment, DirectFileSink::Alignment * 2 + 17})
+        {
+            std::vector<uint8_t> data(size, 0x5A);
+            {
+                DirectBinaryWriter writer(path, DirectFileSink::Alignment);
+                writer.WriteFromMemory(data.data(), data.size());
+            }
+            CHECK(std::filesystem::file_size(path) == size);
+            CHECK(ReadFile(path) == data);
+        }
+
+        // Close() can be called again, e.g. before the destructor
+        DirectFileSink sink(path);
+        sink.Write("abc", 3);
+        sink.Close();
+        sink.Close();
+        CHECK(std::filesystem::file_size(path) == 3);
+    }
+
+    // Seeking far past the buffer leaves a hole instead of writing every zero
+    void TestSparseGap(const std::string &path)
+    {
+        const size_t gap = size_t(1) << 30;
+        {
+            DirectBinaryWriter writer(path, 2 * DirectFileSink::Alignment);
+            writer.WriteUint32(0x11223344);
+            writer.SeekBeg(gap + 5);
+            writer.WriteUint32(0xAABBCCDD);
+            writer.SeekBeg(2);
+            writer.WriteUint8(0x55);
+            CHECK(writer.Length() == gap + 9);
+        }
+        CHECK(std::filesystem::file_size(path) == gap + 9);
+
+        std::ifstream input(path, std::ios::binary);
+        uint8_t head[4];
+        input.read(reinterpret_cast<char *>(head), 4);
+        CHECK(head[0] == 0x44 && head[1] == 0x33 && head[2] == 0x55 && head[3] == 0x11);
+        std::vector<char> zeros(2 * DirectFileSink::Alignment);
+        input.seekg(static_cast<std::streamoff>(gap + 5 - zeros.size()));
+        input.read(zeros.data(), static_cast<std::streamsize>(zeros.size()));
+        CHECK(std::all_of(zeros.begin(), zeros.end(), [](char byte) { return byte == 0; }));
+        uint32_t tail = 0;
+        input.read(reinterpret_cast<char *>(&tail), 4);
+        CHECK(tail == 0xAABBCCDD);
+        input.close();
+
+#if defined(__linux__)
+        struct stat status;
+        CHECK(::stat(path.c_str(), &status) == 0);
+        CHECK(static_cast<size_t>(status.st_blocks) * 512 < gap / 16);
+#endif
+    }
+}
+
+int main()
+{
+    const std::string path = tests::TempPath("direct.bin");
+    TestMatchesModel(path, false);
+    TestMatchesModel(path, true);
+    TestTailTruncation(path);
+    TestSparseGap(path);
+    std::filesystem::remove(path);
+    return 0;
+}
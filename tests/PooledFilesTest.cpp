@@ -0,0 +1,131 @@
+#include <binary_tools/BufferPool.hpp>
+#include <binary_tools/PooledFiles.hpp>
+
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "Test.hpp"
+
+using namespace binary_tools;
+
+namespace
+{
+    std::string FileName(size_t index)
+    {
+        return "pooled_" + std::to_string(index) + ".bin";
+    }
+
+    void TestBufferPool()
+    {
+        BufferPool pool;
+        std::vector<uint8_t> small = pool.Acquire(100);
+        std::vector<uint8_t> large = pool.Acquire(10000);
+        CHECK(small.empty() && small.capacity() >= 100);
+        const uint8_t *largeData = large.data();
+        pool.Release(std::move(small));
+        pool.Release(std::move(large));
+        CHECK(pool.Size() == 2);
+
+        // The smallest buffer that fits is reused
+        std::vector<uint8_t> reused = pool.Acquire(5000);
+        CHECK(reused.data() == largeData && reused.empty());
+        pool.Release(std::move(reused));
+
+        pool.Release(std::vector<uint8_t>(BufferPool::MaxPooledCapacity + 1));
+        pool.Release(std::vector<uint8_t>());
+        CHECK(pool.Size() == 2);
+    }
+
+    // One writer and one reader are reused for every file
+    void TestWriteAndReadMany(const std::filesystem::path &directory)
+    {
+        PooledBinaryWriter writer;
+        for (size_t i = 0; i < 200; i++)
+        {
+            writer.Reset((directory / FileName(i)).string());
+            writer.WriteUint32(static_cast<uint32_t>(i));
+            writer.WriteNullTerminatedString(std::string(i, 'x'));
+        }
+        writer.Flush();
+
+        PooledBinaryReader reader;
+        for (size_t i = 0; i < 200; i++)
+        {
+            reader.Reset((directory / FileName(i)).string());
+            CHECK(reader.Length() == 4 + i + 1);
+            CHECK(reader.ReadUint32() == i);
+            CHECK(reader.ReadNullTerminatedString() == std::string(i, 'x'));
+            CHECK(reader.EndOfStream());
+        }
+
+        CHECK_THROWS(reader.Reset((directory / "missing.bin").string()), std::runtime_error);
+        CHECK(reader.Length() == 0);
+    }
+
+    void TestSmallFileLoader(const std::filesystem::path &directory)
+    {
+        std::vector<std::string> paths;
+        for (size_t i = 0; i < 50; i++)
+            paths.push_back(FileName(i));
+        paths.push_back("missing.bin");
+
+        SmallFileLoader loader(directory.string());
+        size_t next = 0;
+        const size_t loaded = loader.LoadAll(paths, [&](const std::string &path, MemoryBinaryReader &reader)
+                                             {
+                                                 CHECK(path == FileName(next));
+                                                 CHECK(reader.ReadUint32() == next);
+                                                 CHECK(reader.ReadNullTerminatedString() == std::string(next, 'x'));
+                                                 next++;
+                                             });
+        CHECK(loaded == 50 && next == 50);
+
+        std::vector<uint8_t> buffer;
+        CHECK(loader.Load(FileName(3), buffer) && buffer.size() == 8);
+        CHECK(!loader.Load("missing.bin", buffer));
+        CHECK_THROWS(SmallFileLoader((directory / "missing").string()), std::runtime_error);
+    }
+
+    // Files are only written when they changed, and seeking past the end grows them with zeros
+    void TestWriterFlush(const std::filesystem::path &directory)
+    {
+        const std::string path = (directory / "flush.bin").string();
+        {
+            PooledBinaryWriter writer(path);
+            writer.WriteUint8(1);
+            writer.SeekBeg(8);
+            writer.WriteUint8(2);
+        }
+        CHECK(std::filesystem::file_size(path) == 9);
+
+        {
+            PooledBinaryWriter writer(path);
+            writer.Flush();
+            std::filesystem::remove(path);
+            writer.Flush(); // Not dirty, so nothing is written
+        }
+        CHECK(!std::filesystem::exists(path));
+
+        // Write failures are reported by Flush() and Reset()
+        PooledBinaryWriter writer((directory / "missing" / "file.bin").string());
+        writer.WriteUint8(1);
+        CHECK_THROWS(writer.Flush(), std::runtime_error);
+        CHECK_THROWS(writer.Reset(path), std::runtime_error);
+    }
+}
+
+int main()
+{
+    const std::filesystem::path directory = tests::TempPath("pooled");
+    std::filesystem::remove_all(directory);
+    std::filesystem::create_directories(directory);
+
+    TestBufferPool();
+    TestWriteAndReadMany(directory);
+    TestSmallFileLoader(directory);
+    TestWriterFlush(directory);
+
+    std::filesystem::remove_all(directory);
+    return 0;
+}
@@ -0,0 +1,159 @@
+#include <binary_tools/BinaryReader.hpp>
+#include <binary_tools/BinaryWriter.hpp>
+#include <binary_tools/RecordIndex.hpp>
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+#include "Test.hpp"
+
+using namespace binary_tools;
+
+namespace
+{
+    constexpr uint32_t RecordCount = 5000;
+
+    // Records are a key, a payload size and the payload
+    void WriteArchive(const std::string &path, uint32_t keyMultiplier)
+    {
+        BinaryWriter writer(path);
+        for (uint32_t i = 0; i < RecordCount; i++)
+        {
+            writer.WriteUint32(i * keyMultiplier);
+            writer.WriteUint32(i % 50);
+            writer.WriteNullBytes(i % 50);
+        }
+    }
+
+    RecordIndex BuildIndex(const std::string &path, size_t &builds)
+    {
+        builds++;
+        MappedBinaryReader reader(path);
+        return RecordIndex::Build(reader, [](MappedBinaryReader &reader, RecordIndexEntry &entry)
+                                  {
+                                      if (reader.EndOfStream())
+                                          return false;
+
+                                      entry.Offset = reader.Position();
+                                      entry.Key = reader.ReadUint32();
+                                      reader.Skip(reader.ReadUint32());
+                                      entry.Size = reader.Position() - entry.Offset;
+                                      return true;
+                                  });
+    }
+
+    void CheckEntries(const RecordIndex &index, uint32_t keyMultiplier)
+    {
+        CHECK(index.Size() == RecordCount);
+        for (uint32_t i = 0; i < RecordCount; i++)
+        {
+            const RecordIndexEntry *entry = index.Find(i * keyMultiplier);
+            CHECK(entry && entry->Key == i * keyMultiplier && entry->Size == 8 + i % 50);
+        }
+        CHECK(!index.Find(3));
+    }
+
+    void TestSaveAndLoad(const std::string &source, const std::string &sidecar)
+    {
+        size_t builds = 0;
+        const RecordIndex built = RecordIndex::LoadOrBuild(sidecar, source, [&]() { return BuildIndex(source, builds); });
+        CHECK(builds == 1 && !built.IsMapped());
+        CheckEntries(built, 7);
+
+        const RecordIndex loaded = RecordIndex::LoadOrBuild(sidecar, source, [&]() { return BuildIndex(source, builds); });
+        CHECK(builds == 1 && loaded.IsMapped());
+        CheckEntries(loaded, 7);
+        CHECK(RecordIndex::Load(sidecar, source, true));
+    }
+
+    // Any change to the source must invalidate the sidecar, even when the size and write time are kept
+    void TestInvalidation(const std::string &source, const std::string &sidecar)
+    {
+        const auto writeTime = std::filesystem::last_write_time(source);
+        {
+            BinaryWriter writer(source, false);
+            writer.WriteUint32(12345);
+        }
+        std::filesystem::last_write_time(source, writeTime);
+        CHECK(std::filesystem::last_write_time(source) == writeTime);
+        CHECK(!RecordIndex::Load(sidecar, source));
+
+        size_t builds = 0;
+        WriteArchive(source, 11);
+        const RecordIndex rebuilt = RecordIndex::LoadOrBuild(sidecar, source, [&]() { return BuildIndex(source, builds); });
+        CHECK(builds == 1);
+        CheckEntries(rebuilt, 11);
+        CHECK(RecordIndex::Load(sidecar, source));
+
+        // Only the write time changes
+        std::filesystem::last_write_time(source, std::filesystem::last_write_time(source) + std::chrono::seconds(5));
+        CHECK(!RecordIndex::Load(sidecar, source));
+
+        // Only the size changes
+        RecordIndex::LoadOrBuild(sidecar, source, [&]() { return BuildIndex(source, builds); });
+        {
+            std::ofstream append(source, std::ios::binary | std::ios::app);
+            append.put('\0');
+        }
+        CHECK(!RecordIndex::Load(sidecar, source));
+        CHECK(!RecordIndex::Load(sidecar, source + ".missing"));
+    }
+
+    void TestDamagedSidecar(const std::string &source, const std::string &sidecar)
+    {
+        WriteArchive(source, 7);
+        size_t builds = 0;
+        BuildIndex(source, builds).Save(sidecar, source);
+        CHECK(RecordIndex::Load(sidecar, source, true));
+
+        // Corrupt an entry. Only caught when verifying the payload, and lookups stay in bounds either way
+        {
+            BinaryWriter writer(sidecar, false);
+            writer.SeekBeg(sizeof(RecordIndexHeader) + 8);
+            writer.WriteUint64(0xFFFFFFFFFFFF);
+        }
+        CHECK(!RecordIndex::Load(sidecar, source, true));
+        const std::optional<RecordIndex> unverified = RecordIndex::Load(sidecar, source);
+        CHECK(unverified);
+        for (uint32_t i = 0; i < RecordCount; i++)
+            (void)unverified->Find(i * 7);
+
+        // Truncated and missing sidecars
+        std::filesystem::resize_file(sidecar, std::filesystem::file_size(sidecar) - 4);
+        CHECK(!RecordIndex::Load(sidecar, source));
+        std::filesystem::resize_file(sidecar, 10);
+        CHECK(!RecordIndex::Load(sidecar, source));
+        std::filesystem::remove(sidecar);
+        CHECK(!RecordIndex::Load(sidecar, source));
+    }
+
+    // A sidecar that can't be written isn't an error for LoadOrBuild(), and no temp file is left behind
+    void TestUnwritableSidecar(const std::string &source)
+    {
+        const std::string sidecar = tests::TempPath("missing_directory/archive.ridx");
+        size_t builds = 0;
+        CHECK_THROWS(BuildIndex(source, builds).Save(sidecar, source), std::exception);
+        const RecordIndex index = RecordIndex::LoadOrBuild(sidecar, source, [&]() { return BuildIndex(source, builds); });
+        CHECK(builds == 2 && index.Size() == RecordCount);
+        CHECK(!std::filesystem::exists(sidecar + ".tmp"));
+    }
+}
+
+int main()
+{
+    const std::string source = tests::TempPath("archive.bin");
+    const std::string sidecar = source + ".ridx";
+    std::filesystem::remove(sidecar);
+    WriteArchive(source, 7);
+
+    TestSaveAndLoad(source, sidecar);
+    TestInvalidation(source, sidecar);
+    TestDamagedSidecar(source, sidecar);
+    TestUnwritableSidecar(source);
+
+    std::filesystem::remove(source);
+    std::filesystem::remove(sidecar);
+    return 0;
+}
@@ -0,0 +1,136 @@
+#include <binary_tools/BinaryReader.hpp>
+#include <binary_tools/Search.hpp>
+
+#include <fstream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "Test.hpp"
+
+using namespace binary_tools;
+
+namespace
+{
+    // Scalar references for the SIMD kernels in Search.hpp
+    size_t ReferenceFind(const std::vector<uint8_t> &haystack, size_t from, const std::vector<uint8_t> &needle, size_t baseOffset, size_t alignment)
+    {
+        for (size_t i = from; i + needle.size() <= haystack.size(); i++)
+        {
+            if ((baseOffset + i) % alignment == 0 && std::memcmp(haystack.data() + i, needle.data(), needle.size()) == 0)
+                return i;
+        }
+        return NotFound;
+    }
+
+    std::vector<size_t> ReferenceFindAll(const std::vector<uint8_t> &haystack, size_t from, const std::vector<uint8_t> &needle)
+    {
+        std::vector<size_t> offsets;
+        for (size_t i = from; i + needle.size() <= haystack.size(); i++)
+        {
+            if (std::memcmp(haystack.data() + i, needle.data(), needle.size()) == 0)
+                offsets.push_back(i);
+        }
+        return offsets;
+    }
+
+    std::vector<uint8_t> RandomBytes(std::mt19937 &random, size_t size, uint32_t alphabet)
+    {
+        std::vector<uint8_t> bytes(size);
+        for (uint8_t &byte : bytes)
+            byte = static_cast<uint8_t>(random() % alphabet);
+        return bytes;
+    }
+
+    // A small alphabet makes partial matches common so the candidate filtering is exercised
+    void TestKernelsMatchScalar()
+    {
+        std::mt19937 random(30);
+        for (size_t iteration = 0; iteration < 20000; iteration++)
+        {
+            const std::vector<uint8_t> haystack = RandomBytes(random, random() % 200, 3);
+            const std::vector<uint8_t> needle = RandomBytes(random, 1 + random() % 8, 3);
+            CHECK(FindBytes(haystack.data(), haystack.size(), needle.data(), needle.size()) == ReferenceFind(haystack, 0, needle, 0, 1));
+
+            const size_t baseOffset = random() % 64;
+            for (size_t alignment : {1, 2, 3, 4, 8, 16, 32, 64})
+            {
+                const std::vector<uint8_t> value = RandomBytes(random, size_t(1) << (random() % 4), 3);
+                CHECK(FindAligned(haystack.data(), haystack.size(), baseOffset, value.data(), value.size(), alignment) ==
+                      ReferenceFind(haystack, 0, value, baseOffset, alignment));
+            }
+        }
+        CHECK(FindBytes(nullptr, 0, reinterpret_cast<const uint8_t *>("a"), 1) == NotFound);
+    }
+
+    void TestReaders()
+    {
+        std::mt19937 random(300);
+        for (size_t iteration = 0; iteration < 2000; iteration++)
+        {
+            const std::vector<uint8_t> haystack = RandomBytes(random, random() % 300, 3);
+            const std::vector<uint8_t> needle = RandomBytes(random, 1 + random() % 6, 3);
+            const size_t from = haystack.empty() ? 0 : random() % haystack.size();
+            const std::vector<size_t> expected = ReferenceFindAll(haystack, from, needle);
+
+            MemoryBinaryReader reader(haystack.data(), haystack.size());
+            reader.SeekBeg(from);
+            CHECK(reader.FindAll(needle.data(), needle.size()) == expected);
+            const std::optional<size_t> first = reader.Find(needle.data(), needle.size());
+            CHECK(expected.empty() ? !first : *first == expected[0]);
+            CHECK(reader.Position() == from);
+
+            uint32_t value;
+            std::memcpy(&value, needle.data(), std::min<size_t>(needle.size(), 4));
+            if (needle.size() >= 4)
+            {
+                const std::vector<uint8_t> valueBytes(needle.begin(), needle.begin() + 4);
+                const size_t aligned = ReferenceFind(haystack, from, valueBytes, 0, 4);
+                CHECK(reader.FindNext<uint32_t>(value) == (aligned == NotFound ? std::nullopt : std::optional<size_t>(aligned)));
+            }
+        }
+
+        MemoryBinaryReader empty(static_cast<const uint8_t *>(nullptr), 0);
+        CHECK(!empty.Find(""));
+        CHECK(empty.FindAll("").empty());
+    }
+
+    // File streams search a chunk at a time. Matches across chunk boundaries must still be found
+    void TestChunkedSources()
+    {
+        std::mt19937 random(3000);
+        std::vector<uint8_t> data = RandomBytes(random, 3 * 1024 * 1024 + 77, 256);
+        const uint32_t signature = 0xDEADBEEF;
+        for (size_t offset : {size_t(5), size_t(1024 * 1024 - 2), size_t(2 * 1024 * 1024 + 1), data.size() - 4})
+            std::memcpy(data.data() + offset, &signature, 4);
+
+        const std::vector<uint8_t> needle(reinterpret_cast<const uint8_t *>(&signature), reinterpret_cast<const uint8_t *>(&signature) + 4);
+        const std::vector<size_t> expected = ReferenceFindAll(data, 3, needle);
+
+        const std::string path = tests::TempPath("search.bin");
+        {
+            std::ofstream output(path, std::ios::binary);
+            output.write(reinterpret_cast<const char *>(data.data()), static_cast<std::streamsize>(data.size()));
+        }
+        {
+            BinaryReader fileReader(path);
+            fileReader.Skip(3);
+            CHECK(fileReader.FindAll(&signature, 4) == expected);
+            CHECK(fileReader.Position() == 3);
+            CHECK(fileReader.FindNext<uint32_t>(signature, 1) == std::optional<size_t>(5));
+
+            MappedBinaryReader mappedReader(path);
+            mappedReader.Skip(3);
+            CHECK(mappedReader.FindAll(&signature, 4) == expected);
+        }
+        std::remove(path.c_str());
+    }
+}
+
+int main()
+{
+    TestKernelsMatchScalar();
+    TestReaders();
+    TestChunkedSources();
+    return 0;
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <string>
+
+// Checks for the test programs. Unlike assert() they stay enabled in release builds
+#define CHECK(condition)                                                                       \
+    do                                                                                         \
+    {                                                                                          \
+        if (!(condition))                                                                      \
+        {                                                                                      \
+            std::fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #condition); \
+            std::exit(1);                                                                      \
+        }                                                                                      \
+    } while (false)
+
+// Expects statement to throw exceptionType
+#define CHECK_THROWS(statement, exceptionType) \
+    do                                         \
+    {                                          \
+        bool thrown = false;                   \
+        try                                    \
+        {                                      \
+            statement;                         \
+        }                                      \
+        catch (const exceptionType &)          \
+        {                                      \
+            thrown = true;                     \
+        }                                      \
+        CHECK(thrown);                         \
+    } while (false)
+
+namespace binary_tools::tests
+{
+    // Path for a scratch file in the temp directory. Tests remove their files when they pass
+    inline std::string TempPath(const std::string &name)
+    {
+        return (std::filesystem::temp_directory_path() / ("binary_tools_" + name)).string();
+    }
+}
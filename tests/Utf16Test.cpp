@@ -0,0 +1,199 @@
+#include <binary_tools/BinaryReader.hpp>
+#include <binary_tools/BinaryStreamReader.hpp>
+#include <binary_tools/BinaryWriter.hpp>
+#include <binary_tools/Utf16.hpp>
+
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "Test.hpp"
+
+using namespace binary_tools;
+
+namespace
+{
+    // Scalar references for the SIMD kernels in Utf16.hpp
+    size_t ReferenceFindTerminator(const std::u16string &units)
+    {
+        for (size_t i = 0; i < units.size(); i++)
+        {
+            if (units[i] == 0)
+                return i;
+        }
+        return units.size();
+    }
+
+    std::string ReferenceUtf16ToUtf8(const std::u16string &units)
+    {
+        std::string output;
+        for (size_t i = 0; i < units.size(); i++)
+        {
+            uint32_t codePoint = units[i];
+            if (codePoint >= 0xD800 && codePoint <= 0xDFFF)
+            {
+                if (codePoint <= 0xDBFF && i + 1 < units.size() && units[i + 1] >= 0xDC00 && units[i + 1] <= 0xDFFF)
+                    codePoint = 0x10000 + ((codePoint - 0xD800) << 10) + (units[++i] - 0xDC00);
+                else
+                    codePoint = 0xFFFD;
+            }
+
+            if (codePoint < 0x80)
+            {
+                output += static_cast<char>(codePoint);
+            }
+            else if (codePoint < 0x800)
+            {
+                output += static_cast<char>(0xC0 | (codePoint >> 6));
+                output += static_cast<char>(0x80 | (codePoint & 0x3F));
+            }
+            else if (codePoint < 0x10000)
+            {
+                output += static_cast<char>(0xE0 | (codePoint >> 12));
+                output += static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+                output += static_cast<char>(0x80 | (codePoint & 0x3F));
+            }
+            else
+            {
+                output += static_cast<char>(0xF0 | (codePoint >> 18));
+                output += static_cast<char>(0x80 | ((codePoint >> 12) & 0x3F));
+                output += static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+                output += static_cast<char>(0x80 | (codePoint & 0x3F));
+            }
+        }
+        return output;
+    }
+
+    // Mostly ASCII runs so the SIMD blocks are hit, with other characters at random positions to exit them mid block
+    std::u16string RandomUnits(std::mt19937 &random, size_t size, bool allowZero, bool allowUnpaired)
+    {
+        std::u16string units;
+        while (units.size() < size)
+        {
+            const uint32_t kind = random() % 16;
+            if (kind < 10)
+                units += static_cast<char16_t>((allowZero ? 0 : 1) + random() % (allowZero ? 128 : 127));
+            else if (kind < 12)
+                units += static_cast<char16_t>(0x80 + random() % 0x780);
+            else if (kind < 14)
+                units += static_cast<char16_t>(0xE000 + random() % 0x2000);
+            else if (kind == 14 && units.size() + 2 <= size)
+                units += {static_cast<char16_t>(0xD800 + random() % 0x400), static_cast<char16_t>(0xDC00 + random() % 0x400)};
+            else if (allowUnpaired)
+                units += static_cast<char16_t>(0xD800 + random() % 0x800);
+        }
+        return units;
+    }
+
+    std::vector<uint8_t> ToBytes(const std::u16string &units, bool swap, size_t misalignment)
+    {
+        std::vector<uint8_t> bytes(misalignment + units.size() * 2);
+        for (size_t i = 0; i < units.size(); i++)
+        {
+            const uint16_t unit = swap ? ByteSwap16(units[i]) : units[i];
+            std::memcpy(bytes.data() + misalignment + i * 2, &unit, 2);
+        }
+        return bytes;
+    }
+
+    void TestKernelsMatchScalar()
+    {
+        std::mt19937 random(29);
+        for (size_t iteration = 0; iteration < 20000; iteration++)
+        {
+            const size_t size = random() % 100;
+            const bool swap = random() % 2 == 0;
+            const size_t misalignment = random() % 4;
+            const std::u16string units = RandomUnits(random, size, iteration % 2 == 0, true);
+            const std::vector<uint8_t> bytes = ToBytes(units, swap, misalignment);
+            const uint8_t *data = bytes.data() + misalignment;
+
+            CHECK(FindUtf16Terminator(data, units.size()) == ReferenceFindTerminator(units));
+            CHECK(Utf16ToU16String(data, units.size(), swap) == units);
+            const std::string utf8 = Utf16ToUtf8(data, units.size(), swap);
+            CHECK(utf8 == ReferenceUtf16ToUtf8(units));
+
+            // Valid UTF-8 round trips exactly
+            const std::u16string valid = RandomUnits(random, size, false, false);
+            CHECK(Utf8ToU16String(ReferenceUtf16ToUtf8(valid)) == valid);
+        }
+    }
+
+    void TestInvalidUtf8()
+    {
+        CHECK(Utf8ToU16String("a\xFF" "b") == u"a\xFFFD" "b");
+        CHECK(Utf8ToU16String("\xC0\x80") == u"\xFFFD\xFFFD");        // Overlong lead bytes are never valid
+        CHECK(Utf8ToU16String("\xED\xA0\x80") == u"\xFFFD");           // Encoded surrogate
+        CHECK(Utf8ToU16String("\xE2\x82") == u"\xFFFD");               // Truncated
+        CHECK(Utf8ToU16String("\xF0\x9F\x98\x80") == u"\xD83D\xDE00"); // U+1F600
+    }
+
+    void TestReaders()
+    {
+        std::mt19937 random(290);
+        for (size_t iteration = 0; iteration < 500; iteration++)
+        {
+            const std::u16string units = RandomUnits(random, random() % 600, false, true);
+            BasicBinaryWriter<VectorSink, BigEndian> writer;
+            writer.WriteUint8(1); // Misalign the strings
+            writer.WriteNullTerminatedUtf16String(units);
+            writer.WriteFixedLengthUtf16String(units);
+            const std::vector<uint8_t> &buffer = writer.GetSink().Buffer();
+
+            BasicBinaryReader<MemorySource, BigEndian> memoryReader(buffer.data(), buffer.size());
+            memoryReader.Skip(1);
+            CHECK(memoryReader.ReadNullTerminatedUtf16StringAsUtf8() == ReferenceUtf16ToUtf8(units));
+            CHECK(memoryReader.ReadFixedLengthUtf16String(units.size()) == units);
+            CHECK(memoryReader.EndOfStream());
+
+            // Small ring buffers split strings and surrogate pairs across chunks
+            std::istringstream stream(std::string(buffer.begin(), buffer.end()));
+            BasicBinaryReader<RingBufferSource, BigEndian> streamReader(stream, 256);
+            streamReader.Skip(1);
+            CHECK(streamReader.ReadNullTerminatedUtf16String() == units);
+            CHECK(streamReader.ReadFixedLengthUtf16StringAsUtf8(units.size()) == ReferenceUtf16ToUtf8(units));
+            CHECK(streamReader.EndOfStream());
+        }
+
+        // The UTF-8 overloads of the writer transcode
+        VectorBinaryWriter writer;
+        writer.WriteNullTerminatedUtf16String(std::string_view("h\xC3\xA9llo"));
+        const std::vector<uint8_t> &buffer = writer.GetSink().Buffer();
+        MemoryBinaryReader reader(buffer.data(), buffer.size());
+        CHECK(reader.ReadNullTerminatedUtf16String() == u"h\x00E9llo");
+    }
+
+    void TestWideStrings()
+    {
+        const std::u16string units = u"a\xD83D\xDE00" "b\xD800";
+        VectorBinaryWriter writer;
+        writer.WriteNullTerminatedUtf16String(units);
+        const std::vector<uint8_t> &buffer = writer.GetSink().Buffer();
+
+        MemoryBinaryReader reader(buffer.data(), buffer.size());
+        const std::wstring wide = reader.ReadNullTerminatedStringWide();
+        if constexpr (sizeof(wchar_t) == 4)
+        {
+            // Pairs are combined, unpaired surrogates are kept
+            CHECK(wide.size() == 4 && wide[1] == static_cast<wchar_t>(0x1F600) && wide[3] == static_cast<wchar_t>(0xD800));
+        }
+        else
+        {
+            CHECK(wide.size() == units.size() && wide[1] == static_cast<wchar_t>(0xD83D));
+        }
+
+        MemoryBinaryReader fixedReader(buffer.data(), buffer.size());
+        CHECK(fixedReader.ReadFixedLengthStringWide(units.size()) == wide);
+        CHECK(fixedReader.Position() == units.size() * 2);
+    }
+}
+
+int main()
+{
+    TestKernelsMatchScalar();
+    TestInvalidUtf8();
+    TestReaders();
+    TestWideStrings();
+    return 0;
+}
@@ -1,5 +1,11 @@
 add_rules("mode.debug", "mode.release")
 
+option("tests")
+    set_default(false)
+    set_showmenu(true)
+    set_description("Build the test programs in tests/. Run them with xmake test")
+option_end()
+
 target("binary_tools")
     set_kind("headeronly")
     set_languages("c++17")
@@ -7,3 +13,20 @@ target("binary_tools")
     add_headerfiles("include/(**.hpp)")
 
     add_includedirs("include", {public = true})
+
+if has_config("tests") then
+    -- One program per file. AsyncReader needs C++20, everything else builds as C++17 like the library
+    for _, file in ipairs(os.files("tests/*Test.cpp")) do
+        local name = path.basename(file)
+        target(name)
+            set_kind("binary")
+            set_group("tests")
+            set_languages(name == "AsyncReaderTest" and "c++20" or "c++17")
+            add_files(file)
+            add_deps("binary_tools")
+            add_tests("default")
+            if is_plat("linux") then
+                add_syslinks("pthread")
+            end
+    end
+end